@@ -11,17 +11,46 @@ TARGET = WindowsDynamicLightingDriver
 
 SOURCES += \
     src/main.cpp \
-    src/WDLDriverServer.cpp
+    src/WDLDriverServer.cpp \
+    src/WDLIoWorker.cpp \
+    src/WDLFrameConsumer.cpp \
+    src/LampArrayStore.cpp \
+    src/FramePacer.cpp \
+    src/CaptureWriter.cpp \
+    common/SharedFrameRing.cpp
 
 HEADERS += \
     src/WDLDriverServer.h \
-    common/DriverProtocol.h
+    src/WDLIoWorker.h \
+    src/WDLFrameConsumer.h \
+    src/SpscQueue.h \
+    src/DriverMetrics.h \
+    src/LampArrayStore.h \
+    src/LampKernels.h \
+    src/FramePacer.h \
+    src/CaptureWriter.h \
+    common/DriverProtocol.h \
+    common/DriverFramer.h \
+    common/FrameDelta.h \
+    common/DeviceFrame.h \
+    common/SharedFrameRing.h \
+    common/Handshake.h \
+    common/MessageSchema.h \
+    common/DriverStats.h \
+    common/CaptureFormat.h \
+    common/FrameTiming.h
 
 INCLUDEPATH += \
     . \
     common \
     src
 
+# shm_open/shm_unlink (glibc < 2.34)
+unix:!macx:LIBS += -lrt
+
+# timeBeginPeriod (agendador de apresentação)
+win32:LIBS += -lwinmm
+
 win32:DEFINES += \
     _CRT_SECURE_NO_WARNINGS \
     WIN32_LEAN_AND_MEAN
@@ -0,0 +1,348 @@
+// Replay de capturas gravadas com WindowsDynamicLightingDriver --record.
+//
+// O arquivo é mapeado em memória (QFile::map) e cada pacote é reenviado
+// direto do mapeamento, com uma conexão por cliente gravado, respeitando
+// os timestamps da captura:
+//   CaptureReplay captura.wdlc              velocidade original
+//   CaptureReplay captura.wdlc --speed 4    4x mais rápido
+//   CaptureReplay captura.wdlc --speed 0    sem pausas (o mais rápido possível)
+//
+// Ao final reporta o throughput (mensagens/s, frames/s, MB/s), o atraso de
+// cada envio em relação ao agendamento, o RTT de Pings intercalados durante
+// o replay, a latência por frame (FrameAck) e, por conexão, as métricas do próprio driver (GetStats).
+// Pings e consultas de status gravados não são reenviados: o replay usa os
+// seus próprios. TimedFrames são reenviados com sentNs novo e o horário de
+// apresentação reposicionado para manter a antecedência original; os
+// FrameAcks do driver dão a latência de envio -> recepção.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QLocalSocket>
+#include <QTextStream>
+#include <QThread>
+
+#include "CaptureFormat.h"
+#include "DriverFramer.h"
+#include "DriverStats.h"
+#include "FrameTiming.h"
+#include "MessageSchema.h"
+#include "DriverMetrics.h"
+
+using namespace DriverProtocol;
+using DriverMetrics::Histogram;
+
+namespace {
+
+constexpr qint64 PollIntervalNs = 1000000;       // leitura das respostas
+constexpr qint64 MaxBufferedBytes = 1024 * 1024; // acima disso aguarda o socket
+
+struct Connection {
+    QLocalSocket socket;
+    Framer rx { 4096 };
+    qint64 pingSentNs = 0; // 0 = nenhum Ping pendente
+    DriverStats stats;
+    bool statsReceived = false;
+    quint64 keyframeRequests = 0;
+};
+
+struct Replay {
+    QString serverName;
+    double speed = 1.0;
+    qint64 pingIntervalNs = 100000000;
+
+    QElapsedTimer clock;
+    QHash<quint32, Connection*> connections;
+    QByteArray tx;
+    QByteArray retimeScratch;
+
+    quint64 messages = 0;
+    quint64 frames = 0;
+    quint64 bytes = 0;
+    quint64 skipped = 0;
+    Histogram lagNs;
+    Histogram rttNs;
+    Histogram oneWayNs; // FrameAck: envio -> recepção no driver
+
+    ~Replay() { qDeleteAll(connections); }
+
+    Connection* connection(quint32 clientId)
+    {
+        Connection* conn = connections.value(clientId);
+        if (conn) return conn;
+
+        conn = new Connection;
+        conn->socket.connectToServer(serverName);
+        if (!conn->socket.waitForConnected(3000)) {
+            QTextStream(stderr) << "cannot connect to '" << serverName << "': " << conn->socket.errorString() << "\n";
+            delete conn;
+            return nullptr;
+        }
+        connections.insert(clientId, conn);
+        return conn;
+    }
+
+    void send(Connection* conn, const char* data, int size)
+    {
+        conn->socket.write(data, size);
+        conn->socket.flush();
+        if (conn->socket.bytesToWrite() > MaxBufferedBytes) {
+            conn->socket.waitForBytesWritten(1000);
+        }
+    }
+
+    // Lê e trata as respostas já disponíveis (ou aguarda até timeoutMs)
+    void pump(Connection* conn, int timeoutMs)
+    {
+        if (conn->socket.bytesAvailable() == 0 && !conn->socket.waitForReadyRead(timeoutMs)) return;
+
+        const qint64 available = conn->socket.bytesAvailable();
+        if (available <= 0) return;
+        char* dst = conn->rx.prepareWrite(static_cast<int>(available));
+        const qint64 n = conn->socket.read(dst, available);
+        if (n <= 0) return;
+        conn->rx.commitWrite(static_cast<int>(n));
+
+        const qint64 now = clock.nsecsElapsed();
+        conn->rx.consume([this, conn, now](MessageType type, const PayloadView& payload) {
+            switch (type) {
+            case MessageType::Pong:
+                if (conn->pingSentNs != 0) {
+                    rttNs.record(static_cast<quint64>(now - conn->pingSentNs));
+                    conn->pingSentNs = 0;
+                }
+                break;
+            case MessageType::FrameAck: {
+                quint32 seq = 0;
+                qint64 sentNs = 0;
+                qint64 receivedNs = 0;
+                if (FrameAckMsg::decode(payload, seq, sentNs, receivedNs) && receivedNs >= sentNs) {
+                    oneWayNs.record(static_cast<quint64>(receivedNs - sentNs));
+                }
+                break;
+            }
+            case MessageType::StatsResponse:
+                conn->statsReceived = conn->stats.decode(payload);
+                break;
+            case MessageType::RequestKeyframe:
+                ++conn->keyframeRequests;
+                break;
+            default:
+                break;
+            }
+        });
+    }
+
+    void ping(Connection* conn)
+    {
+        if (conn->pingSentNs != 0) return;
+        tx.resize(0);
+        PingMsg::packInto(tx);
+        conn->pingSentNs = clock.nsecsElapsed();
+        send(conn, tx.constData(), tx.size());
+    }
+
+    // Cópia do TimedFrame com sentNs = agora e o horário de apresentação
+    // deslocado para agora + antecedência gravada
+    void sendRetimed(Connection* conn, const CaptureRecord& rec, qint64 startClockNs)
+    {
+        FrameStamp stamp;
+        MessageType inner;
+        PayloadView frame;
+        if (!parseTimedFrame(rec.payload, stamp, inner, frame)) {
+            send(conn, rec.packet, rec.packetSize);
+            return;
+        }
+
+        const qint64 now = presentationClockNs();
+        const qint64 recordedAt = startClockNs + static_cast<qint64>(rec.timestampNs);
+        stamp.sentNs = now;
+        if (stamp.presentAtNs != 0) stamp.presentAtNs = now + (stamp.presentAtNs - recordedAt);
+
+        encodeTimedFrame(stamp, inner, frame.data, frame.size, retimeScratch);
+        tx.resize(0);
+        packInto(tx, MessageType::TimedFrame, retimeScratch.constData(), retimeScratch.size());
+        send(conn, tx.constData(), tx.size());
+    }
+
+    // Espera até o instante agendado: dorme a maior parte, gira no final
+    void waitUntil(qint64 targetNs)
+    {
+        for (;;) {
+            const qint64 remaining = targetNs - clock.nsecsElapsed();
+            if (remaining <= 0) return;
+            if (remaining > 2000000) {
+                QThread::usleep(static_cast<unsigned long>((remaining - 1000000) / 1000));
+            } else {
+                QThread::yieldCurrentThread();
+            }
+        }
+    }
+
+    bool run(CaptureReader& reader)
+    {
+        clock.start();
+        qint64 lastPollNs = 0;
+        qint64 lastPingNs = 0;
+        bool haveBase = false;
+        quint64 baseTs = 0;
+
+        CaptureRecord rec;
+        while (reader.next(rec)) {
+            if (rec.type == MessageType::Ping || rec.type == MessageType::GetStatus
+                || rec.type == MessageType::GetStats) {
+                ++skipped;
+                continue;
+            }
+
+            if (!haveBase) {
+                baseTs = rec.timestampNs;
+                haveBase = true;
+            }
+            if (speed > 0.0) {
+                const qint64 target = static_cast<qint64>(static_cast<double>(rec.timestampNs - baseTs) / speed);
+                waitUntil(target);
+                lagNs.record(static_cast<quint64>(clock.nsecsElapsed() - target));
+            }
+
+            Connection* conn = connection(rec.clientId);
+            if (!conn) return false;
+            if (rec.type == MessageType::TimedFrame && rec.payload.size >= TimedFrameHeaderSize) {
+                sendRetimed(conn, rec, reader.startClockNs());
+            } else {
+                send(conn, rec.packet, rec.packetSize);
+            }
+
+            ++messages;
+            bytes += static_cast<quint64>(rec.packetSize);
+            if (isFrameMessage(rec.type)) ++frames;
+
+            const qint64 now = clock.nsecsElapsed();
+            if (now - lastPingNs >= pingIntervalNs) {
+                for (Connection* c : connections) ping(c);
+                lastPingNs = now;
+            }
+            if (now - lastPollNs >= PollIntervalNs) {
+                for (Connection* c : connections) pump(c, 0);
+                lastPollNs = now;
+            }
+        }
+        return true;
+    }
+
+    // Esvazia os envios, mede um último RTT e coleta o GetStats de cada conexão
+    void finish()
+    {
+        for (Connection* conn : connections) {
+            while (conn->socket.bytesToWrite() > 0 && conn->socket.waitForBytesWritten(1000)) {
+            }
+            conn->pingSentNs = 0;
+            ping(conn);
+            tx.resize(0);
+            GetStatsMsg::packInto(tx);
+            send(conn, tx.constData(), tx.size());
+        }
+
+        QElapsedTimer deadline;
+        deadline.start();
+        for (Connection* conn : connections) {
+            while (!conn->statsReceived && deadline.elapsed() < 3000) pump(conn, 100);
+        }
+    }
+};
+
+QString us(quint64 ns)
+{
+    return QString::number(static_cast<double>(ns) / 1000.0, 'f', 1);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("CaptureReplay");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replay de capturas do WindowsDynamicLightingDriver");
+    parser.addHelpOption();
+    parser.addPositionalArgument("capture", "Arquivo gravado com --record");
+    QCommandLineOption nameOpt({"n", "name"}, "Nome do servidor QLocalServer", "name", "OpenRGB_WDL_Driver");
+    QCommandLineOption speedOpt({"s", "speed"}, "Multiplicador de velocidade (1 = original, 0 = sem pausas)", "factor", "1");
+    QCommandLineOption pingOpt("ping-ms", "Intervalo entre Pings de medição de RTT", "ms", "100");
+    parser.addOption(nameOpt);
+    parser.addOption(speedOpt);
+    parser.addOption(pingOpt);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1) {
+        parser.showHelp(1);
+    }
+
+    QFile file(args.first());
+    if (!file.open(QIODevice::ReadOnly)) {
+        out << "cannot open " << args.first() << ": " << file.errorString() << "\n";
+        return 1;
+    }
+    const uchar* mapped = file.map(0, file.size());
+    if (!mapped) {
+        out << "cannot map " << args.first() << ": " << file.errorString() << "\n";
+        return 1;
+    }
+
+    CaptureReader reader(reinterpret_cast<const char*>(mapped), file.size());
+    if (!reader.isValid()) {
+        out << args.first() << " is not a WDL capture (versions 1-" << CaptureVersion << ")\n";
+        return 1;
+    }
+
+    Replay replay;
+    replay.serverName = parser.value(nameOpt);
+    replay.speed = qMax(0.0, parser.value(speedOpt).toDouble());
+    replay.pingIntervalNs = qMax(1, parser.value(pingOpt).toInt()) * qint64(1000000);
+
+    if (!replay.run(reader)) return 1;
+    const qint64 sendNs = replay.clock.nsecsElapsed();
+    replay.finish();
+
+    const double seconds = qMax(1e-9, static_cast<double>(sendNs) / 1e9);
+    out << "capture: " << args.first() << " (" << file.size() << " bytes"
+        << (reader.isTruncated() ? ", truncated tail ignored" : "") << ")\n";
+    out << "speed: " << (replay.speed > 0.0 ? QString::number(replay.speed) + "x" : QString("flat out"))
+        << ", connections: " << replay.connections.size() << "\n";
+    out << "sent " << replay.messages << " messages (" << replay.frames << " frames, "
+        << replay.skipped << " recorded pings/status skipped) in " << QString::number(seconds, 'f', 3) << " s\n";
+    out << "throughput: " << QString::number(replay.messages / seconds, 'f', 0) << " msg/s, "
+        << QString::number(replay.frames / seconds, 'f', 0) << " frames/s, "
+        << QString::number(replay.bytes / seconds / (1024.0 * 1024.0), 'f', 2) << " MiB/s\n";
+    if (replay.lagNs.count() > 0) {
+        out << "schedule lag: p50 " << us(replay.lagNs.percentile(0.50)) << " us, p99 "
+            << us(replay.lagNs.percentile(0.99)) << " us\n";
+    }
+    out << "ping rtt: " << replay.rttNs.count() << " samples, p50 " << us(replay.rttNs.percentile(0.50))
+        << " us, p99 " << us(replay.rttNs.percentile(0.99)) << " us\n";
+    if (replay.oneWayNs.count() > 0) {
+        out << "frame one-way latency: " << replay.oneWayNs.count() << " acks, p50 "
+            << us(replay.oneWayNs.percentile(0.50)) << " us, p99 " << us(replay.oneWayNs.percentile(0.99)) << " us\n";
+    }
+
+    for (auto it = replay.connections.constBegin(); it != replay.connections.constEnd(); ++it) {
+        const Connection* conn = it.value();
+        out << "client " << it.key() << ": ";
+        if (!conn->statsReceived) {
+            out << "no GetStats reply\n";
+            continue;
+        }
+        const DriverStats& s = conn->stats;
+        out << s.framesIn << " frames in, " << s.framesApplied << " applied, " << s.framesSuperseded
+            << " superseded, " << s.framesDropped << " dropped, " << s.framesLate << " late, " << s.deltasRejected << " deltas rejected ("
+            << conn->keyframeRequests << " keyframe requests); parse p50 " << us(s.parseP50Ns)
+            << " us p99 " << us(s.parseP99Ns) << " us; apply latency p50 " << us(s.latencyP50Ns)
+            << " us p99 " << us(s.latencyP99Ns) << " us\n";
+    }
+    return 0;
+}
@@ -0,0 +1,28 @@
+#-----------------------------------------------------------------------------------------------#
+# Driver Capture Replay (Console) - QMake Project                                               #
+#-----------------------------------------------------------------------------------------------#
+
+QT += core network
+QT -= gui
+CONFIG += console c++17
+CONFIG -= app_bundle
+TEMPLATE = app
+
+TARGET = CaptureReplay
+
+SOURCES += \
+    CaptureReplay.cpp
+
+HEADERS += \
+    ../common/DriverProtocol.h \
+    ../common/DriverFramer.h \
+    ../common/MessageSchema.h \
+    ../common/DriverStats.h \
+    ../common/CaptureFormat.h \
+    ../src/DriverMetrics.h
+
+INCLUDEPATH += \
+    ../common \
+    ../src
+
+QMAKE_CXXFLAGS += -Wall -Wextra
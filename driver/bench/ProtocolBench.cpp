@@ -0,0 +1,335 @@
+// Microbenchmark do framing do protocolo Plugin <-> Driver.
+//
+// Compara o caminho legado (tryUnpack: mid() + remove() por mensagem) com o
+// Framer sobre arena. Para cada tamanho de backlog N, um lote de N frames
+// chega de uma vez (como em um readAll() após um burst) e mede-se o custo
+// médio por frame. O Framer deve manter custo constante conforme N cresce;
+// o caminho legado cresce linearmente por frame (O(N²) por lote).
+//
+// A varredura de payload vai de 3 bytes (1 LED) até 131072 LEDs e mede
+// pack/packInto e unpack com leituras coalescidas (vários frames por
+// leitura) e fragmentadas (pedaços de 64 e 1500 bytes, como um socket
+// entregando o frame aos poucos).
+//
+// Os dois caminhos conferem quantos frames decodificaram: um parser que
+// trava ou consome demais no meio do lote invalida a comparação, e o bench
+// falha em vez de imprimir um número.
+//
+// Também mede pack/unpack de mensagens pequenas: o empacotamento antigo
+// via QDataStream (reproduzido aqui como referência "antes") contra o
+// pack() de layout fixo e o MessageSchema escrevendo em buffer reutilizado.
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QDataStream>
+
+#include "DriverProtocol.h"
+#include "DriverFramer.h"
+#include "MessageSchema.h"
+
+using namespace DriverProtocol;
+
+namespace {
+
+// Evita que o compilador elimine o laço medido
+volatile qint64 g_sink = 0;
+
+QByteArray makeBacklog(int frames, int payloadSize)
+{
+    const QByteArray payload(payloadSize, '\x7f');
+    const QByteArray one = pack(MessageType::SetLedColors, payload);
+
+    QByteArray stream;
+    stream.reserve(one.size() * frames);
+    for (int i = 0; i < frames; ++i) {
+        stream.append(one);
+    }
+    return stream;
+}
+
+// Frames decodificados diferentes de frames * reps invalidam a medida
+double benchLegacy(const QByteArray& stream, int frames, int reps, bool& complete)
+{
+    MessageType type;
+    QByteArray payload;
+    qint64 checksum = 0;
+    qint64 decoded = 0;
+
+    QElapsedTimer t;
+    t.start();
+    for (int r = 0; r < reps; ++r) {
+        QByteArray buffer = stream;
+        while (tryUnpack(buffer, type, payload)) {
+            checksum += payload.size();
+            ++decoded;
+        }
+    }
+    const qint64 ns = t.nsecsElapsed();
+    g_sink = g_sink + checksum;
+    complete = decoded == static_cast<qint64>(frames) * reps;
+    return static_cast<double>(ns) / (static_cast<double>(frames) * reps);
+}
+
+double benchFramer(const QByteArray& stream, int frames, int reps, bool& complete)
+{
+    Framer framer;
+    qint64 checksum = 0;
+    qint64 decoded = 0;
+
+    QElapsedTimer t;
+    t.start();
+    for (int r = 0; r < reps; ++r) {
+        framer.append(stream.constData(), stream.size());
+        framer.consume([&checksum, &decoded](MessageType, const PayloadView& payload) {
+            checksum += payload.size;
+            ++decoded;
+        });
+    }
+    const qint64 ns = t.nsecsElapsed();
+    g_sink = g_sink + checksum;
+    complete = decoded == static_cast<qint64>(frames) * reps;
+    return static_cast<double>(ns) / (static_cast<double>(frames) * reps);
+}
+
+// MB/s a partir de bytes e nanossegundos
+double mbps(qint64 bytes, qint64 ns)
+{
+    return ns > 0 ? (static_cast<double>(bytes) * 1000.0) / static_cast<double>(ns) : 0.0;
+}
+
+// Entrega 'stream' ao framer em pedaços de 'chunk' bytes (0 = tudo de uma vez)
+qint64 feedFramer(Framer& framer, const QByteArray& stream, int chunk)
+{
+    qint64 frames = 0;
+    const int step = chunk > 0 ? chunk : stream.size();
+    for (int at = 0; at < stream.size(); at += step) {
+        const int n = qMin(step, stream.size() - at);
+        framer.append(stream.constData() + at, n);
+        frames += framer.consume([](MessageType, const PayloadView& payload) {
+            g_sink = g_sink + payload.size;
+        });
+    }
+    return frames;
+}
+
+void benchPayloadSweep(QTextStream& out)
+{
+    const int payloadSizes[] = { 3, 30, 300, 3000, 30000, 300000, 131072 * 3 };
+    const qint64 targetBytes = 256LL * 1024 * 1024;
+
+    out << "\npayload bytes   pack MB/s  packInto MB/s  coalesced MB/s  frag1500 MB/s  frag64 MB/s  legacy MB/s\n";
+
+    for (int size : payloadSizes) {
+        const QByteArray payload(size, '\x3c');
+        const int frameBytes = HeaderSize + size;
+        const int frames = static_cast<int>(qBound<qint64>(16, targetBytes / frameBytes, 1000000));
+        QElapsedTimer t;
+
+        // pack(): um QByteArray novo por mensagem
+        t.start();
+        for (int i = 0; i < frames; ++i) {
+            g_sink = g_sink + pack(MessageType::SetLedColors, payload).size();
+        }
+        const double packRate = mbps(static_cast<qint64>(frames) * frameBytes, t.nsecsElapsed());
+
+        // packInto(): buffer reutilizado
+        QByteArray reuse;
+        reuse.reserve(frameBytes);
+        t.start();
+        for (int i = 0; i < frames; ++i) {
+            reuse.resize(0);
+            packInto(reuse, MessageType::SetLedColors, payload.constData(), payload.size());
+            g_sink = g_sink + reuse.size();
+        }
+        const double packIntoRate = mbps(static_cast<qint64>(frames) * frameBytes, t.nsecsElapsed());
+
+        // Stream com até ~4 MiB de frames enfileirados, repetido até o alvo
+        const int perStream = qMax(1, qMin(frames, (4 * 1024 * 1024) / frameBytes));
+        const QByteArray stream = makeBacklog(perStream, size);
+        const int reps = qMax(1, frames / perStream);
+
+        double rates[3];
+        const int chunks[3] = { 0, 1500, 64 };
+        for (int c = 0; c < 3; ++c) {
+            Framer framer;
+            // Fragmentado em 64 bytes é lento por natureza: menos repetições
+            const int r = chunks[c] == 64 ? qMax(1, reps / 8) : reps;
+            t.start();
+            for (int i = 0; i < r; ++i) {
+                feedFramer(framer, stream, chunks[c]);
+            }
+            rates[c] = mbps(static_cast<qint64>(stream.size()) * r, t.nsecsElapsed());
+        }
+
+        // Legado (tryUnpack) com leitura coalescida
+        MessageType type;
+        QByteArray legacyPayload;
+        const int legacyReps = qMax(1, reps / 8);
+        t.start();
+        for (int i = 0; i < legacyReps; ++i) {
+            QByteArray buffer = stream;
+            while (tryUnpack(buffer, type, legacyPayload)) {
+                g_sink = g_sink + legacyPayload.size();
+            }
+        }
+        const double legacyRate = mbps(static_cast<qint64>(stream.size()) * legacyReps, t.nsecsElapsed());
+
+        out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+                   .arg(size, 13)
+                   .arg(packRate, 10, 'f', 1)
+                   .arg(packIntoRate, 14, 'f', 1)
+                   .arg(rates[0], 15, 'f', 1)
+                   .arg(rates[1], 14, 'f', 1)
+                   .arg(rates[2], 12, 'f', 1)
+                   .arg(legacyRate, 12, 'f', 1);
+        out.flush();
+    }
+}
+
+// Empacotamento como era antes do MessageSchema: QDataStream para o float
+// e de novo para o cabeçalho, com um QByteArray novo a cada etapa.
+QByteArray legacyPackBrightness(float value)
+{
+    QByteArray payload;
+    QDataStream ds(&payload, QIODevice::WriteOnly);
+    ds.setByteOrder(QDataStream::LittleEndian);
+    // O código antigo serializava double (padrão do QDataStream); aqui
+    // força float para comparar o mesmo payload de 4 bytes
+    ds.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    ds << value;
+
+    QByteArray buffer;
+    QDataStream out(&buffer, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << static_cast<quint32>(sizeof(quint16) + payload.size());
+    out << static_cast<quint16>(MessageType::SetBrightness);
+    out.writeRawData(payload.constData(), payload.size());
+    return buffer;
+}
+
+// Retorna milhões de mensagens por segundo
+double mps(qint64 messages, qint64 ns)
+{
+    return ns > 0 ? (static_cast<double>(messages) * 1000.0) / static_cast<double>(ns) : 0.0;
+}
+
+void benchSmallMessages(QTextStream& out)
+{
+    const int n = 1000000;
+    qint64 checksum = 0;
+    QElapsedTimer t;
+
+    // pack: antes (QDataStream)
+    t.start();
+    for (int i = 0; i < n; ++i) {
+        checksum += legacyPackBrightness(static_cast<float>(i & 0xFF) / 255.0f).size();
+    }
+    const double packLegacy = mps(n, t.nsecsElapsed());
+
+    // pack(): layout fixo, ainda alocando o resultado
+    QByteArray payload(static_cast<int>(sizeof(float)), Qt::Uninitialized);
+    t.start();
+    for (int i = 0; i < n; ++i) {
+        const float v = static_cast<float>(i & 0xFF) / 255.0f;
+        memcpy(payload.data(), &v, sizeof(v));
+        checksum += pack(MessageType::SetBrightness, payload).size();
+    }
+    const double packFixed = mps(n, t.nsecsElapsed());
+
+    // MessageSchema: buffer do chamador reutilizado (lote de 1024 mensagens)
+    QByteArray stream;
+    stream.reserve(SetBrightnessMsg::packetSize * 1024);
+    t.start();
+    for (int i = 0; i < n; ++i) {
+        if ((i & 1023) == 0) stream.resize(0);
+        checksum += SetBrightnessMsg::packInto(stream, static_cast<float>(i & 0xFF) / 255.0f);
+    }
+    const double packSchema = mps(n, t.nsecsElapsed());
+
+    // unpack: antes (tryUnpack + memcpy) vs Framer + decoder do schema
+    QByteArray batch;
+    for (int i = 0; i < 1024; ++i) {
+        SetBrightnessMsg::packInto(batch, static_cast<float>(i) / 1024.0f);
+    }
+    const int batches = n / 1024;
+
+    MessageType type;
+    QByteArray legacyPayload;
+    double sum = 0.0;
+    t.start();
+    for (int b = 0; b < batches; ++b) {
+        QByteArray buffer = batch;
+        while (tryUnpack(buffer, type, legacyPayload)) {
+            float v = 0.0f;
+            if (legacyPayload.size() >= static_cast<int>(sizeof(float))) {
+                memcpy(&v, legacyPayload.constData(), sizeof(float));
+            }
+            sum += v;
+        }
+    }
+    const double unpackLegacy = mps(static_cast<qint64>(batches) * 1024, t.nsecsElapsed());
+
+    Framer framer;
+    t.start();
+    for (int b = 0; b < batches; ++b) {
+        framer.append(batch.constData(), batch.size());
+        framer.consume([&sum](MessageType, const PayloadView& p) {
+            float v = 0.0f;
+            if (SetBrightnessMsg::decode(p, v)) sum += v;
+        });
+    }
+    const double unpackSchema = mps(static_cast<qint64>(batches) * 1024, t.nsecsElapsed());
+
+    g_sink = g_sink + checksum + static_cast<qint64>(sum);
+
+    out << "\nSetBrightness (" << SetBrightnessMsg::packetSize << " bytes), Mmsg/s\n";
+    out << QString("pack   QDataStream (antes)   %1\n").arg(packLegacy, 8, 'f', 2);
+    out << QString("pack   pack() layout fixo    %1\n").arg(packFixed, 8, 'f', 2);
+    out << QString("pack   MessageSchema         %1\n").arg(packSchema, 8, 'f', 2);
+    out << QString("unpack tryUnpack (antes)     %1\n").arg(unpackLegacy, 8, 'f', 2);
+    out << QString("unpack Framer + schema       %1\n").arg(unpackSchema, 8, 'f', 2);
+    out.flush();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    const int payloadSize = 300; // 100 LEDs RGB888
+    const int backlogs[] = { 1, 8, 64, 512, 4096, 16384 };
+    const qint64 targetFrames = 200000;
+
+    out << "payload=" << payloadSize << " bytes\n";
+    out << "backlog      legacy ns/frame   framer ns/frame\n";
+
+    for (int n : backlogs) {
+        const QByteArray stream = makeBacklog(n, payloadSize);
+        const int reps = static_cast<int>(qMax<qint64>(1, targetFrames / n));
+        // Legacy é quadrático: limitar repetições nos backlogs grandes
+        const int legacyReps = n >= 4096 ? qMax(1, reps / 16) : reps;
+
+        bool legacyComplete = false;
+        bool framerComplete = false;
+        const double legacy = benchLegacy(stream, n, legacyReps, legacyComplete);
+        const double framer = benchFramer(stream, n, reps, framerComplete);
+        if (!legacyComplete || !framerComplete) {
+            out << "backlog " << n << ": " << (legacyComplete ? "framer" : "tryUnpack")
+                << " did not decode every frame; comparison invalid\n";
+            return 1;
+        }
+
+        out << QString("%1 %2 %3\n")
+                   .arg(n, 7)
+                   .arg(legacy, 18, 'f', 1)
+                   .arg(framer, 17, 'f', 1);
+        out.flush();
+    }
+
+    benchPayloadSweep(out);
+    benchSmallMessages(out);
+    return 0;
+}
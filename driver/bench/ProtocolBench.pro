@@ -0,0 +1,24 @@
+#-----------------------------------------------------------------------------------------------#
+# Driver Protocol Benchmark (Console) - QMake Project                                           #
+#-----------------------------------------------------------------------------------------------#
+
+QT += core
+QT -= gui
+CONFIG += console c++17
+CONFIG -= app_bundle
+TEMPLATE = app
+
+TARGET = ProtocolBench
+
+SOURCES += \
+    ProtocolBench.cpp
+
+HEADERS += \
+    ../common/DriverProtocol.h \
+    ../common/DriverFramer.h \
+    ../common/MessageSchema.h
+
+INCLUDEPATH += \
+    ../common
+
+QMAKE_CXXFLAGS += -Wall -Wextra
@@ -0,0 +1,222 @@
+// Alvo de fuzzing do framer e dos decodificadores do protocolo.
+//
+// Com libFuzzer (clang):
+//   qmake ProtocolFuzz.pro CONFIG+=libfuzzer QMAKE_CXX=clang++ QMAKE_LINK=clang++
+//   ./ProtocolFuzz corpus/
+//
+// Sem libFuzzer o mesmo binário roda sozinho: arquivos passados na linha de
+// comando são executados uma vez cada; sem argumentos (ou com -runs=N) gera
+// streams aleatórios misturando frames válidos e cabeçalhos de length
+// malformados (0, 1, enormes, truncados).
+//
+// O primeiro byte da entrada define o tamanho dos pedaços entregues ao
+// Framer e ao caminho legado (tryUnpack), cobrindo leituras fragmentadas e
+// coalescidas. Um tryUnpack que devolve true sem consumir bytes aborta: o
+// laço do chamador nunca terminaria.
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTextStream>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "DriverProtocol.h"
+#include "DriverFramer.h"
+#include "FrameDelta.h"
+#include "DeviceFrame.h"
+#include "Handshake.h"
+#include "MessageSchema.h"
+#include "DriverStats.h"
+#include "FrameTiming.h"
+
+using namespace DriverProtocol;
+
+namespace {
+
+volatile quint64 g_sink = 0;
+
+// Passa o payload por todos os decodificadores, independente do type
+void decodeAll(const PayloadView& payload, QByteArray& reference)
+{
+    quint64 sum = 0;
+    for (int i = 0; i < payload.size; ++i) {
+        sum += static_cast<uchar>(payload.data[i]);
+    }
+
+    DeviceFrameView frame;
+    if (frame.parse(payload)) {
+        for (int i = 0; i < frame.entryCount(); ++i) {
+            const DeviceFrameEntry e = frame.entry(i);
+            const char* colors = frame.entryColors(i);
+            for (quint32 led = 0; led < e.count; ++led) {
+                sum += static_cast<uchar>(colors[led * 3]);
+            }
+        }
+    }
+
+    applyDelta(reference, payload);
+
+    Capabilities caps;
+    if (caps.decode(payload)) sum += caps.encodings;
+
+    float brightness = 0.0f;
+    if (SetBrightnessMsg::decode(payload, brightness)) sum += static_cast<quint64>(brightness != 0.0f);
+
+    quint64 seq = 0;
+    if (FrameDoorbellMsg::decode(payload, seq)) sum += seq;
+
+    qint64 sentNs = 0;
+    qint64 driverNs = 0;
+    if (PongStampedMsg::decode(payload, sentNs, driverNs)) sum += static_cast<quint64>(driverNs - sentNs);
+    quint32 ackSeq = 0;
+    if (FrameAckMsg::decode(payload, ackSeq, sentNs, driverNs)) sum += ackSeq;
+
+    DriverStats stats;
+    if (stats.decode(payload)) sum += stats.framesIn;
+
+    FrameStamp stamp;
+    MessageType inner = MessageType::SetLedColors;
+    PayloadView timed;
+    if (parseTimedFrame(payload, stamp, inner, timed)) {
+        sum += stamp.seq + static_cast<quint64>(stamp.presentAtNs) + static_cast<quint64>(timed.size);
+        if (frame.parse(timed)) sum += static_cast<quint64>(frame.entryCount());
+    }
+
+    g_sink = g_sink + sum;
+}
+
+void exercise(const uint8_t* data, size_t size)
+{
+    if (size == 0) return;
+
+    const int chunk = 1 + data[0];
+    Framer framer(64);
+    framer.setMaxFrameSize(1 << 20);
+    QByteArray reference(30, '\0'); // referência de 10 LEDs para os deltas
+
+    for (size_t at = 1; at < size && !framer.hasError(); at += chunk) {
+        const int n = static_cast<int>(qMin<size_t>(chunk, size - at));
+        framer.append(reinterpret_cast<const char*>(data + at), n);
+        framer.consume([&reference](MessageType, const PayloadView& payload) {
+            decodeAll(payload, reference);
+        });
+    }
+
+    // Mesmo stream pelo caminho legado
+    QByteArray buffer;
+    QByteArray legacyPayload;
+    MessageType type = MessageType::Ping;
+    bool corrupt = false;
+    reference.fill('\0');
+
+    for (size_t at = 1; at < size && !corrupt; at += chunk) {
+        const int n = static_cast<int>(qMin<size_t>(chunk, size - at));
+        buffer.append(reinterpret_cast<const char*>(data + at), n);
+        for (;;) {
+            const int before = buffer.size();
+            if (!tryUnpack(buffer, type, legacyPayload, &corrupt)) break;
+            if (buffer.size() >= before) abort();
+
+            PayloadView payload;
+            payload.data = legacyPayload.constData();
+            payload.size = legacyPayload.size();
+            decodeAll(payload, reference);
+        }
+    }
+}
+
+#ifndef WDL_LIBFUZZER
+
+void appendHeader(QByteArray& out, quint32 length, quint16 type)
+{
+    char h[HeaderSize];
+    qToLittleEndian<quint32>(length, h);
+    qToLittleEndian<quint16>(type, h + sizeof(quint32));
+    out.append(h, HeaderSize);
+}
+
+// Stream aleatório: frames válidos intercalados com cabeçalhos quebrados
+QByteArray randomStream(QRandomGenerator& rng)
+{
+    static const quint16 types[] = { 1, 2, 3, 4, 10, 11, 12, 13, 14, 15, 16, 20, 21, 22, 23, 30, 31, 32, 0xFFFF };
+
+    QByteArray out;
+    out.append(static_cast<char>(rng.bounded(256)));
+
+    const int frames = 1 + static_cast<int>(rng.bounded(32u));
+    for (int f = 0; f < frames; ++f) {
+        const quint16 type = types[rng.bounded(static_cast<quint32>(sizeof(types) / sizeof(types[0])))];
+        const int payloadSize = static_cast<int>(rng.bounded(512u));
+
+        quint32 length = static_cast<quint32>(sizeof(quint16) + payloadSize);
+        switch (rng.bounded(10u)) {
+        case 0: length = 0; break;                  // menor que o type
+        case 1: length = 1; break;
+        case 2: length = 0xFFFFFFFFu; break;        // enorme
+        case 3: length = (1u << 20) + 1; break;     // logo acima do limite
+        case 4: length += rng.bounded(64u); break;  // payload truncado
+        default: break;
+        }
+
+        appendHeader(out, length, type);
+        for (int i = 0; i < payloadSize; ++i) {
+            out.append(static_cast<char>(rng.bounded(256)));
+        }
+    }
+    return out;
+}
+
+#endif
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    exercise(data, size);
+    return 0;
+}
+
+#ifndef WDL_LIBFUZZER
+
+int main(int argc, char* argv[])
+{
+    QTextStream out(stdout);
+    int runs = 100000;
+    int files = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const QByteArray arg(argv[i]);
+        if (arg.startsWith("-runs=")) {
+            runs = arg.mid(6).toInt();
+            continue;
+        }
+
+        QFile f(QString::fromLocal8Bit(argv[i]));
+        if (!f.open(QIODevice::ReadOnly)) {
+            out << "cannot open " << arg << "\n";
+            return 1;
+        }
+        const QByteArray input = f.readAll();
+        exercise(reinterpret_cast<const uint8_t*>(input.constData()), static_cast<size_t>(input.size()));
+        ++files;
+    }
+
+    if (files > 0) {
+        out << "executed " << files << " inputs\n";
+        return 0;
+    }
+
+    QRandomGenerator rng(0x5744u);
+    for (int r = 0; r < runs; ++r) {
+        const QByteArray input = randomStream(rng);
+        exercise(reinterpret_cast<const uint8_t*>(input.constData()), static_cast<size_t>(input.size()));
+    }
+    out << "executed " << runs << " random streams\n";
+    return 0;
+}
+
+#endif
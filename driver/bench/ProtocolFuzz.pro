@@ -0,0 +1,37 @@
+#-----------------------------------------------------------------------------------------------#
+# Driver Protocol Fuzz Target (Console) - QMake Project                                         #
+#                                                                                               #
+# Standalone:  qmake ProtocolFuzz.pro && make && ./ProtocolFuzz -runs=100000                    #
+# libFuzzer:   qmake ProtocolFuzz.pro CONFIG+=libfuzzer QMAKE_CXX=clang++ QMAKE_LINK=clang++    #
+#-----------------------------------------------------------------------------------------------#
+
+QT += core
+QT -= gui
+CONFIG += console c++17
+CONFIG -= app_bundle
+TEMPLATE = app
+
+TARGET = ProtocolFuzz
+
+SOURCES += \
+    ProtocolFuzz.cpp
+
+HEADERS += \
+    ../common/DriverProtocol.h \
+    ../common/DriverFramer.h \
+    ../common/FrameDelta.h \
+    ../common/DeviceFrame.h \
+    ../common/Handshake.h \
+    ../common/MessageSchema.h \
+    ../common/DriverStats.h
+
+INCLUDEPATH += \
+    ../common
+
+QMAKE_CXXFLAGS += -Wall -Wextra
+
+libfuzzer {
+    DEFINES += WDL_LIBFUZZER
+    QMAKE_CXXFLAGS += -fsanitize=fuzzer,address,undefined
+    QMAKE_LFLAGS   += -fsanitize=fuzzer,address,undefined
+}
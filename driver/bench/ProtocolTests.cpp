@@ -0,0 +1,603 @@
+// Testes do protocolo sem socket nem driver:
+//  - framing: pacotes consecutivos no mesmo buffer são decodificados um a
+//    um, tanto por tryUnpack() quanto pelo Framer, sem consumir bytes do
+//    pacote seguinte, e cabeçalhos com length inválido são recusados sem
+//    consumir nada;
+//  - deltas: encodeDelta/applyDelta reconstroem o frame e applyDelta
+//    recusa payloads inválidos sem tocar na referência;
+//  - SetDeviceFrame: o que encodeDeviceFrame escreve é lido de volta por
+//    DeviceFrameView, que recusa tabelas apontando para fora das cores;
+//  - SharedFrameRing: escritor e leitor no mesmo processo (POSIX shm ou
+//    file mapping), volta do anel, perdas contadas e nunca entregues pela
+//    metade, frames maiores que o slot recusados, geometria alterada pelo
+//    escritor depois do open() ignorada pelo leitor.
+//
+//   qmake ProtocolTests.pro && make && ./ProtocolTests   (código 0 = ok)
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QTextStream>
+#include <QCoreApplication>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <string>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "DriverProtocol.h"
+#include "DriverFramer.h"
+#include "FrameDelta.h"
+#include "DeviceFrame.h"
+#include "SharedFrameRing.h"
+
+using namespace DriverProtocol;
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool ok, const char* what, QTextStream& out)
+{
+    if (!ok) {
+        out << "FAIL: " << what << "\n";
+        ++g_failures;
+    }
+}
+
+// Dois pacotes seguidos, o segundo sem payload
+QByteArray backToBack(const QByteArray& colors)
+{
+    QByteArray stream = pack(MessageType::SetLedColors, colors);
+    stream.append(pack(MessageType::Ping, QByteArray()));
+    return stream;
+}
+
+void testTryUnpackBackToBack(QTextStream& out)
+{
+    const QByteArray colors("\x01\x02\x03\x04\x05\x06", 6);
+    QByteArray buffer = backToBack(colors);
+
+    MessageType type = MessageType::GetStatus;
+    QByteArray payload;
+    check(tryUnpack(buffer, type, payload), "tryUnpack: first packet decoded", out);
+    check(type == MessageType::SetLedColors, "tryUnpack: first packet type", out);
+    check(payload == colors, "tryUnpack: first packet payload", out);
+    check(buffer.size() == HeaderSize, "tryUnpack: second packet left intact", out);
+
+    check(tryUnpack(buffer, type, payload), "tryUnpack: second packet decoded", out);
+    check(type == MessageType::Ping, "tryUnpack: second packet type", out);
+    check(payload.isEmpty(), "tryUnpack: second packet payload", out);
+    check(buffer.isEmpty(), "tryUnpack: buffer fully consumed", out);
+    check(!tryUnpack(buffer, type, payload), "tryUnpack: nothing left", out);
+}
+
+void testTryUnpackPartialSecond(QTextStream& out)
+{
+    const QByteArray colors("\x0a\x0b\x0c", 3);
+    QByteArray buffer = pack(MessageType::SetLedColors, colors);
+    buffer.append(pack(MessageType::SetLedColors, colors).left(HeaderSize + 1));
+
+    MessageType type = MessageType::GetStatus;
+    QByteArray payload;
+    check(tryUnpack(buffer, type, payload), "tryUnpack partial: first packet decoded", out);
+    check(payload == colors, "tryUnpack partial: first packet payload", out);
+    check(!tryUnpack(buffer, type, payload), "tryUnpack partial: waits for the rest", out);
+    check(buffer.size() == HeaderSize + 1, "tryUnpack partial: incomplete packet kept", out);
+}
+
+// Cabeçalho com 'length' arbitrário seguido de alguns bytes
+QByteArray rawHeader(quint32 length)
+{
+    QByteArray buffer(HeaderSize, '\0');
+    qToLittleEndian<quint32>(length, buffer.data());
+    qToLittleEndian<quint16>(static_cast<quint16>(MessageType::SetLedColors), buffer.data() + sizeof(quint32));
+    buffer.append("\x01\x02\x03\x04", 4);
+    return buffer;
+}
+
+void testTryUnpackBadLength(QTextStream& out)
+{
+    static const struct {
+        quint32 length;
+        const char* what;
+    } cases[] = {
+        { 0, "tryUnpack: length 0 rejected" },
+        { 1, "tryUnpack: length 1 rejected" },
+        { DefaultMaxFrameSize + 1, "tryUnpack: length above max rejected" },
+        { 0x7FFFFFFCu, "tryUnpack: length overflowing int rejected" },
+        { 0xFFFFFFFFu, "tryUnpack: length 0xFFFFFFFF rejected" },
+    };
+
+    for (const auto& c : cases) {
+        QByteArray buffer = rawHeader(c.length);
+        const int before = buffer.size();
+        MessageType type = MessageType::GetStatus;
+        QByteArray payload;
+        bool corrupt = false;
+        const bool decoded = tryUnpack(buffer, type, payload, &corrupt);
+        check(!decoded && corrupt && buffer.size() == before, c.what, out);
+    }
+
+    // Limite exato ainda é válido: só aguarda o resto do payload
+    QByteArray buffer = rawHeader(DefaultMaxFrameSize);
+    MessageType type = MessageType::GetStatus;
+    QByteArray payload;
+    bool corrupt = true;
+    check(!tryUnpack(buffer, type, payload, &corrupt) && !corrupt, "tryUnpack: max length waits for data", out);
+}
+
+void testFramerBackToBack(QTextStream& out)
+{
+    const QByteArray colors("\x01\x02\x03\x04\x05\x06", 6);
+    const QByteArray stream = backToBack(colors);
+
+    Framer framer(16);
+    framer.append(stream.constData(), stream.size());
+
+    int count = 0;
+    bool firstOk = false;
+    bool secondOk = false;
+    framer.consume([&](MessageType type, const PayloadView& payload) {
+        if (count == 0) firstOk = type == MessageType::SetLedColors && payload.toByteArray() == colors;
+        if (count == 1) secondOk = type == MessageType::Ping && payload.isEmpty();
+        ++count;
+    });
+    check(count == 2, "Framer: two packets delivered", out);
+    check(firstOk, "Framer: first packet", out);
+    check(secondOk, "Framer: second packet", out);
+    check(!framer.hasError(), "Framer: no error", out);
+}
+
+// Frame de 'leds' LEDs com um padrão que não se repete entre vizinhos
+QByteArray patternFrame(int leds)
+{
+    QByteArray frame(leds * 3, '\0');
+    for (int i = 0; i < frame.size(); ++i) {
+        frame.data()[i] = static_cast<char>(i * 7 + 1);
+    }
+    return frame;
+}
+
+PayloadView viewOf(const QByteArray& bytes)
+{
+    PayloadView view;
+    view.data = bytes.constData();
+    view.size = bytes.size();
+    return view;
+}
+
+// encodeDelta seguido de applyDelta sobre uma cópia de prev
+bool roundTrip(const QByteArray& prev, const QByteArray& next)
+{
+    QByteArray delta;
+    if (!encodeDelta(prev, next, delta)) return false;
+    QByteArray ref = prev;
+    return applyDelta(ref, viewOf(delta)) && ref == next;
+}
+
+void testDeltaIdentical(QTextStream& out)
+{
+    const QByteArray frame = patternFrame(64);
+    QByteArray delta;
+    check(encodeDelta(frame, frame, delta), "delta identical: encoded", out);
+    check(delta.size() == DeltaHeaderSize, "delta identical: header only", out);
+    check(roundTrip(frame, frame), "delta identical: round trip", out);
+}
+
+void testDeltaSingleLed(QTextStream& out)
+{
+    const int leds = 64;
+    const QByteArray prev = patternFrame(leds);
+    const int positions[] = { 0, leds / 2, leds - 1 };
+    const char* names[] = { "delta single LED: start", "delta single LED: middle", "delta single LED: end" };
+    for (int i = 0; i < 3; ++i) {
+        QByteArray next = prev;
+        next.data()[positions[i] * 3 + 1] ^= 0x5A;
+        QByteArray delta;
+        const bool encoded = encodeDelta(prev, next, delta);
+        check(encoded && delta.size() == DeltaHeaderSize + DeltaRunHeaderSize + 3, names[i], out);
+        check(roundTrip(prev, next), names[i], out);
+    }
+}
+
+void testDeltaAllChanged(QTextStream& out)
+{
+    const QByteArray prev = patternFrame(64);
+    QByteArray next = prev;
+    for (int i = 0; i < next.size(); ++i) next.data()[i] = static_cast<char>(~next.data()[i]);
+
+    // Delta não fica menor que o keyframe: o chamador envia SetLedColors
+    QByteArray delta;
+    check(!encodeDelta(prev, next, delta), "delta all changed: falls back to keyframe", out);
+}
+
+void testDeltaSizeMismatch(QTextStream& out)
+{
+    const QByteArray prev = patternFrame(64);
+    const QByteArray next = patternFrame(65);
+    QByteArray delta;
+    check(!encodeDelta(prev, next, delta), "delta size mismatch: not encoded", out);
+
+    // Delta válido para 65 LEDs sobre uma referência de 64
+    QByteArray longer = next;
+    longer.data()[0] ^= 0x01;
+    check(encodeDelta(next, longer, delta), "delta size mismatch: encoded for 65 LEDs", out);
+    QByteArray ref = prev;
+    check(!applyDelta(ref, viewOf(delta)), "delta size mismatch: rejected", out);
+    check(ref == prev, "delta size mismatch: reference untouched", out);
+
+    QByteArray empty;
+    check(!applyDelta(empty, viewOf(delta)), "delta size mismatch: empty reference rejected", out);
+}
+
+void testDeltaMalformed(QTextStream& out)
+{
+    const QByteArray prev = patternFrame(64);
+    QByteArray next = prev;
+    next.data()[10 * 3] ^= 0x11;
+    next.data()[40 * 3] ^= 0x22;
+    QByteArray delta;
+    check(encodeDelta(prev, next, delta), "delta malformed: encoded", out);
+
+    // Qualquer corte (cabeçalho, cabeçalho de run ou cores) é recusado
+    bool allRejected = true;
+    bool untouched = true;
+    for (int cut = 0; cut < delta.size(); ++cut) {
+        QByteArray ref = prev;
+        if (applyDelta(ref, viewOf(delta.left(cut)))) allRejected = false;
+        if (!(ref == prev)) untouched = false;
+    }
+    check(allRejected, "delta truncated: rejected", out);
+    check(untouched, "delta truncated: reference untouched", out);
+
+    // Segundo run movido para além do fim: o primeiro não pode ser aplicado
+    QByteArray outOfRange = delta;
+    const int secondRun = DeltaHeaderSize + DeltaRunHeaderSize + 3;
+    qToLittleEndian<quint32>(64, outOfRange.data() + secondRun);
+    QByteArray ref = prev;
+    check(!applyDelta(ref, viewOf(outOfRange)), "delta out of range: rejected", out);
+    check(ref == prev, "delta out of range: reference untouched", out);
+
+    // start + count transbordando ledCount, com as cores do run completas
+    QByteArray overflow = delta;
+    qToLittleEndian<quint32>(63, overflow.data() + secondRun);
+    qToLittleEndian<quint16>(2, overflow.data() + secondRun + sizeof(quint32));
+    overflow.append("\x01\x02\x03", 3);
+    ref = prev;
+    check(!applyDelta(ref, viewOf(overflow)), "delta run past end: rejected", out);
+}
+
+QVector<DeviceFrameEntry> sampleLayout()
+{
+    QVector<DeviceFrameEntry> entries;
+    DeviceFrameEntry e;
+    e.deviceId = 0; e.zoneId = 0; e.offset = 0;  e.count = 10; entries.append(e);
+    e.deviceId = 0; e.zoneId = 1; e.offset = 10; e.count = 4;  entries.append(e);
+    e.deviceId = 3; e.zoneId = 2; e.offset = 14; e.count = 18; entries.append(e);
+    return entries;
+}
+
+void testDeviceFrameRoundTrip(QTextStream& out)
+{
+    const QVector<DeviceFrameEntry> entries = sampleLayout();
+    const QByteArray colors = patternFrame(32);
+    QByteArray payload;
+    encodeDeviceFrame(entries, colors, payload);
+    check(payload.size() == DeviceFrameHeaderSize + entries.size() * DeviceFrameEntrySize + colors.size(),
+          "device frame: encoded size", out);
+
+    DeviceFrameView view;
+    check(view.parse(viewOf(payload)), "device frame: parsed", out);
+    check(view.entryCount() == entries.size(), "device frame: entry count", out);
+    check(view.ledCount() == 32, "device frame: LED count", out);
+    check(view.colors().toByteArray() == colors, "device frame: color block", out);
+
+    bool entriesOk = view.entryCount() == entries.size();
+    bool colorsOk = entriesOk;
+    for (int i = 0; entriesOk && i < entries.size(); ++i) {
+        entriesOk = view.entry(i) == entries[i];
+        const QByteArray zone(view.entryColors(i), static_cast<int>(entries[i].count) * 3);
+        colorsOk = colorsOk && zone == colors.mid(static_cast<int>(entries[i].offset) * 3, zone.size());
+    }
+    check(entriesOk, "device frame: entries", out);
+    check(colorsOk, "device frame: entry colors", out);
+
+    // Reutilizar o buffer de saída com um frame menor
+    QVector<DeviceFrameEntry> single;
+    single.append(entries[0]);
+    encodeDeviceFrame(single, colors.left(30), payload);
+    check(view.parse(viewOf(payload)) && view.entryCount() == 1 && view.ledCount() == 10,
+          "device frame: reused buffer", out);
+}
+
+void testDeviceFrameRejected(QTextStream& out)
+{
+    const QByteArray colors = patternFrame(32);
+    DeviceFrameView view;
+    QByteArray payload;
+
+    // offset + count além do bloco de cores (inclusive por transbordo de 32 bits)
+    const quint32 bad[][2] = { { 30, 3 }, { 32, 1 }, { 0, 33 }, { 0xFFFFFFFFu, 2 } };
+    bool allRejected = true;
+    for (const auto& b : bad) {
+        QVector<DeviceFrameEntry> entries = sampleLayout();
+        entries[1].offset = b[0];
+        entries[1].count = b[1];
+        encodeDeviceFrame(entries, colors, payload);
+        if (view.parse(viewOf(payload))) allRejected = false;
+    }
+    check(allRejected, "device frame: entry past color block rejected", out);
+    check(view.entryCount() == 0, "device frame: rejected view is empty", out);
+
+    // Entrada que termina exatamente no fim é válida
+    QVector<DeviceFrameEntry> edge = sampleLayout();
+    edge[2].offset = 31;
+    edge[2].count = 1;
+    encodeDeviceFrame(edge, colors, payload);
+    check(view.parse(viewOf(payload)), "device frame: entry ending at last LED accepted", out);
+
+    // Tabela truncada e bloco de cores fora de múltiplo de 3
+    encodeDeviceFrame(sampleLayout(), colors, payload);
+    check(!view.parse(viewOf(payload.left(DeviceFrameHeaderSize + DeviceFrameEntrySize))),
+          "device frame: truncated table rejected", out);
+    check(!view.parse(viewOf(payload.left(payload.size() - 1))), "device frame: partial LED rejected", out);
+    check(!view.parse(viewOf(payload.left(1))), "device frame: truncated header rejected", out);
+}
+
+// Nome único por processo: create() falha se a região já existe
+QString ringName(const char* test)
+{
+    return QString("WDLRingTest-") + QString::number(QCoreApplication::applicationPid()) + "-" + test;
+}
+
+// Frame com todos os bytes iguais a seq: um frame misturado aparece na hora
+QByteArray seqFrame(quint64 seq, int size)
+{
+    return QByteArray(size, static_cast<char>(seq & 0xFF));
+}
+
+bool isSeqFrame(const PayloadView& payload, quint64 seq, int size)
+{
+    if (payload.size != size) return false;
+    for (int i = 0; i < size; ++i) {
+        if (payload.bytes()[i] != static_cast<uchar>(seq & 0xFF)) return false;
+    }
+    return true;
+}
+
+void testRingPublishDrain(QTextStream& out)
+{
+    SharedFrameRing writer;
+    SharedFrameRing reader;
+    check(writer.create(ringName("drain"), 4, 64), "ring: created", out);
+    check(reader.open(writer.name()), "ring: opened", out);
+    check(reader.slotCount() == 4 && reader.slotSize() == 64, "ring: geometry from header", out);
+
+    quint64 last = 0;
+    for (quint64 i = 1; i <= 3; ++i) {
+        last = writer.publish(static_cast<quint16>(MessageType::SetLedColors), seqFrame(i, 30).constData(), 30);
+    }
+    check(last == 3, "ring: sequence numbers", out);
+
+    QByteArray scratch;
+    quint64 expected = 1;
+    bool ok = true;
+    const int delivered = reader.drain(last, scratch, [&](MessageType type, const PayloadView& payload) {
+        ok = ok && type == MessageType::SetLedColors && isSeqFrame(payload, expected, 30);
+        ++expected;
+    });
+    check(delivered == 3 && ok, "ring: frames drained in order", out);
+    check(reader.droppedFrames() == 0, "ring: nothing dropped", out);
+    check(reader.drain(last, scratch, [](MessageType, const PayloadView&) {}) == 0, "ring: drained once", out);
+}
+
+void testRingWrapAround(QTextStream& out)
+{
+    SharedFrameRing writer;
+    SharedFrameRing reader;
+    check(writer.create(ringName("wrap"), 4, 64) && reader.open(writer.name()), "ring wrap: opened", out);
+
+    // 3 frames por doorbell com 4 slots: o índice dá várias voltas sem perda
+    QByteArray scratch;
+    quint64 expected = 1;
+    bool ok = true;
+    int delivered = 0;
+    for (int batch = 0; batch < 5; ++batch) {
+        quint64 last = 0;
+        for (int i = 0; i < 3; ++i) {
+            const quint64 seq = expected + static_cast<quint64>(i);
+            last = writer.publish(static_cast<quint16>(MessageType::SetLedColors), seqFrame(seq, 16 + i).constData(), 16 + i);
+        }
+        delivered += reader.drain(last, scratch, [&](MessageType, const PayloadView& payload) {
+            ok = ok && isSeqFrame(payload, expected, 16 + static_cast<int>((expected - 1) % 3));
+            ++expected;
+        });
+    }
+    check(delivered == 15 && ok, "ring wrap: every frame delivered intact", out);
+    check(reader.droppedFrames() == 0, "ring wrap: nothing dropped", out);
+}
+
+void testRingOverwrite(QTextStream& out)
+{
+    SharedFrameRing writer;
+    SharedFrameRing reader;
+    check(writer.create(ringName("overwrite"), 4, 64) && reader.open(writer.name()), "ring overwrite: opened", out);
+
+    // 6 frames sem drenar: 1 e 2 foram sobrescritos por 5 e 6
+    quint64 last = 0;
+    for (quint64 seq = 1; seq <= 6; ++seq) {
+        last = writer.publish(static_cast<quint16>(MessageType::SetLedColors), seqFrame(seq, 32).constData(), 32);
+    }
+    quint16 type = 0;
+    QByteArray scratch;
+    check(!reader.read(1, type, scratch), "ring overwrite: stale slot not readable", out);
+
+    quint64 expected = 3;
+    bool ok = true;
+    const int delivered = reader.drain(last, scratch, [&](MessageType, const PayloadView& payload) {
+        ok = ok && isSeqFrame(payload, expected, 32);
+        ++expected;
+    });
+    check(delivered == 4 && ok, "ring overwrite: newest frames delivered", out);
+    check(reader.droppedFrames() == 2, "ring overwrite: losses counted", out);
+
+    // Escritor concorrente dando voltas no anel: o leitor pode perder
+    // frames, mas tudo o que entrega é um frame inteiro
+    SharedFrameRing racer;
+    SharedFrameRing racerReader;
+    check(racer.create(ringName("race"), 2, 4096) && racerReader.open(racer.name()), "ring race: opened", out);
+    std::atomic<quint64> published { 0 };
+    std::atomic<bool> done { false };
+    std::thread producer([&]() {
+        for (quint64 seq = 1; seq <= 20000; ++seq) {
+            const QByteArray frame = seqFrame(seq, 4096);
+            published.store(racer.publish(static_cast<quint16>(MessageType::SetLedColors), frame.constData(), frame.size()),
+                            std::memory_order_release);
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    bool intact = true;
+    quint64 seen = 0;
+    quint64 lastSeq = 0;
+    while (!done.load(std::memory_order_acquire) || lastSeq < published.load(std::memory_order_acquire)) {
+        const quint64 upTo = published.load(std::memory_order_acquire);
+        if (upTo <= lastSeq) continue;
+        racerReader.drain(upTo, scratch, [&](MessageType, const PayloadView& payload) {
+            // Todos os bytes iguais ao primeiro: sem mistura de dois frames
+            intact = intact && payload.size == 4096 && isSeqFrame(payload, payload.bytes()[0], 4096);
+            ++seen;
+        });
+        lastSeq = upTo;
+    }
+    producer.join();
+    check(intact, "ring race: no torn frame delivered", out);
+    check(seen + racerReader.droppedFrames() == 20000, "ring race: every frame delivered or counted", out);
+}
+
+void testRingOversize(QTextStream& out)
+{
+    SharedFrameRing writer;
+    check(writer.create(ringName("oversize"), 2, 64), "ring oversize: created", out);
+    const QByteArray frame(65, 'x');
+    check(writer.publish(static_cast<quint16>(MessageType::SetLedColors), frame.constData(), 65) == 0,
+          "ring oversize: larger than slot rejected", out);
+    check(writer.publish(static_cast<quint16>(MessageType::SetLedColors), frame.constData(), 64) == 1,
+          "ring oversize: exact slot size accepted", out);
+    check(writer.publish(static_cast<quint16>(MessageType::SetLedColors), frame.constData(), -1) == 0,
+          "ring oversize: negative size rejected", out);
+}
+
+// Mapeamento cru do cabeçalho do anel, como outro processo o veria
+class RawRingHeader {
+public:
+    explicit RawRingHeader(const QString& name)
+    {
+#ifdef Q_OS_WIN
+        const std::wstring wname = (QStringLiteral("Local\\") + name).toStdWString();
+        m_mapping = OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, wname.c_str());
+        if (m_mapping) m_data = static_cast<char*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, Size));
+#else
+        const int fd = shm_open(("/" + name.toUtf8()).constData(), O_RDWR, 0);
+        if (fd >= 0) {
+            void* view = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (view != MAP_FAILED) m_data = static_cast<char*>(view);
+            ::close(fd);
+        }
+#endif
+    }
+
+    ~RawRingHeader()
+    {
+#ifdef Q_OS_WIN
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle(m_mapping);
+#else
+        if (m_data) munmap(m_data, Size);
+#endif
+    }
+
+    bool isValid() const { return m_data != nullptr; }
+
+    // [uint32 magic][uint32 version][uint32 slotCount][uint32 slotSize]...
+    void setSlotCount(quint32 v) { memcpy(m_data + 8, &v, sizeof(v)); }
+    void setSlotSize(quint32 v) { memcpy(m_data + 12, &v, sizeof(v)); }
+
+private:
+    static constexpr size_t Size = 16;
+    char* m_data = nullptr;
+#ifdef Q_OS_WIN
+    HANDLE m_mapping = nullptr;
+#endif
+};
+
+void testRingGeometryTampered(QTextStream& out)
+{
+    SharedFrameRing writer;
+    SharedFrameRing reader;
+    check(writer.create(ringName("tamper"), 4, 64) && reader.open(writer.name()), "ring tamper: opened", out);
+
+    RawRingHeader raw(writer.name());
+    check(raw.isValid(), "ring tamper: raw header mapped", out);
+    if (!raw.isValid()) return;
+
+    // Slots maiores e em maior número que o mapeado pelo leitor
+    raw.setSlotCount(0x10000000u);
+    raw.setSlotSize(0x40000000u);
+    check(reader.slotCount() == 4 && reader.slotSize() == 64, "ring tamper: reader keeps validated geometry", out);
+
+    QByteArray scratch;
+    quint64 last = 0;
+    for (quint64 seq = 1; seq <= 6; ++seq) {
+        last = writer.publish(static_cast<quint16>(MessageType::SetLedColors), seqFrame(seq, 48).constData(), 48);
+    }
+    quint64 expected = 3;
+    bool ok = true;
+    const int delivered = reader.drain(last, scratch, [&](MessageType, const PayloadView& payload) {
+        ok = ok && isSeqFrame(payload, expected, 48);
+        ++expected;
+    });
+    check(delivered == 4 && ok, "ring tamper: frames read inside the mapping", out);
+
+    // slotCount 0 no cabeçalho não chega ao módulo do índice
+    raw.setSlotCount(0);
+    last = writer.publish(static_cast<quint16>(MessageType::SetLedColors), seqFrame(7, 48).constData(), 48);
+    quint16 type = 0;
+    check(reader.read(last, type, scratch) && isSeqFrame(PayloadView{ scratch.constData(), scratch.size() }, 7, 48),
+          "ring tamper: zero slot count ignored", out);
+}
+
+} // namespace
+
+int main()
+{
+    QTextStream out(stdout);
+
+    testTryUnpackBackToBack(out);
+    testTryUnpackPartialSecond(out);
+    testTryUnpackBadLength(out);
+    testFramerBackToBack(out);
+    testDeltaIdentical(out);
+    testDeltaSingleLed(out);
+    testDeltaAllChanged(out);
+    testDeltaSizeMismatch(out);
+    testDeltaMalformed(out);
+    testDeviceFrameRoundTrip(out);
+    testDeviceFrameRejected(out);
+    testRingPublishDrain(out);
+    testRingWrapAround(out);
+    testRingOverwrite(out);
+    testRingOversize(out);
+    testRingGeometryTampered(out);
+
+    out << (g_failures == 0 ? "all protocol tests passed\n" : "protocol tests failed\n");
+    return g_failures == 0 ? 0 : 1;
+}
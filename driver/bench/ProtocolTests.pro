@@ -0,0 +1,31 @@
+#-----------------------------------------------------------------------------------------------#
+# Driver Protocol Tests (Console) - QMake Project                                               #
+#                                                                                               #
+#   qmake ProtocolTests.pro && make && ./ProtocolTests                                          #
+#-----------------------------------------------------------------------------------------------#
+
+QT += core
+QT -= gui
+CONFIG += console c++17
+CONFIG -= app_bundle
+TEMPLATE = app
+
+TARGET = ProtocolTests
+
+SOURCES += \
+    ProtocolTests.cpp \
+    ../common/SharedFrameRing.cpp
+
+HEADERS += \
+    ../common/DriverProtocol.h \
+    ../common/DriverFramer.h \
+    ../common/FrameDelta.h \
+    ../common/DeviceFrame.h \
+    ../common/SharedFrameRing.h
+
+INCLUDEPATH += \
+    ../common
+
+unix:!macx:LIBS += -lrt
+
+QMAKE_CXXFLAGS += -Wall -Wextra
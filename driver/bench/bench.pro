@@ -0,0 +1,20 @@
+#-----------------------------------------------------------------------------------------------#
+# Driver Protocol Benchmark, Fuzz and Replay Targets - QMake Project                            #
+#                                                                                               #
+# Builds without OpenRGB (QtCore; CaptureReplay also needs QtNetwork):                          #
+#   qmake bench.pro && make && ./ProtocolTests && ./ProtocolBench && ./ProtocolFuzz             #
+#   ./CaptureReplay captura.wdlc --speed 0   (captura gravada com o driver em --record)         #
+#-----------------------------------------------------------------------------------------------#
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    protocol_tests \
+    protocol_bench \
+    protocol_fuzz \
+    capture_replay
+
+protocol_tests.file = ProtocolTests.pro
+protocol_bench.file = ProtocolBench.pro
+protocol_fuzz.file  = ProtocolFuzz.pro
+capture_replay.file = CaptureReplay.pro
@@ -0,0 +1,131 @@
+#ifndef CAPTURE_FORMAT_H
+#define CAPTURE_FORMAT_H
+
+#include <QtGlobal>
+#include <QtEndian>
+
+#include <cstring>
+
+#include "DriverProtocol.h"
+#include "DriverFramer.h"
+
+namespace DriverProtocol {
+
+// Arquivo de captura do driver (little-endian, só acrescentado):
+//
+//   [char magic[4] "WDLC"][uint16 version][uint16 reserved][uint64 startEpochMs][uint64 startClockNs]
+//   registros: [uint64 timestampNs][uint32 clientId][pacote exatamente como no fio]
+//
+// timestampNs é monotônico, relativo ao início da gravação e não decresce
+// ao longo do arquivo. O pacote inclui o cabeçalho do protocolo, então o
+// replay pode reenviá-lo direto do mapeamento, sem remontar nada.
+//
+// startClockNs (versão 2) é o relógio de apresentação no início da gravação:
+// startClockNs + timestampNs está no mesmo domínio dos horários de
+// TimedFrame, o que permite ao replay reposicioná-los. Capturas da versão 1
+// (cabeçalho de 16 bytes, sem o campo) continuam legíveis.
+constexpr char CaptureMagic[4] = { 'W', 'D', 'L', 'C' };
+constexpr quint16 CaptureVersion = 2;
+constexpr int CaptureFileHeaderSize = 24;
+constexpr int CaptureRecordHeaderSize = static_cast<int>(sizeof(quint64) + sizeof(quint32));
+
+inline int captureFileHeaderSize(quint16 version)
+{
+    return version >= 2 ? CaptureFileHeaderSize : 16;
+}
+
+inline void writeCaptureFileHeader(char* dst, quint64 startEpochMs, qint64 startClockNs)
+{
+    memcpy(dst, CaptureMagic, sizeof(CaptureMagic));
+    qToLittleEndian<quint16>(CaptureVersion, dst + 4);
+    qToLittleEndian<quint16>(0, dst + 6);
+    qToLittleEndian<quint64>(startEpochMs, dst + 8);
+    qToLittleEndian<qint64>(startClockNs, dst + 16);
+}
+
+inline void writeCaptureRecordHeader(char* dst, quint64 timestampNs, quint32 clientId)
+{
+    qToLittleEndian<quint64>(timestampNs, dst);
+    qToLittleEndian<quint32>(clientId, dst + sizeof(quint64));
+}
+
+struct CaptureRecord {
+    quint64 timestampNs = 0;
+    quint32 clientId = 0;
+    MessageType type = MessageType::Ping;
+    const char* packet = nullptr; // cabeçalho + payload, pronto para reenvio
+    int packetSize = 0;
+    PayloadView payload;
+};
+
+// Percorre uma captura em memória (tipicamente QFile::map) sem copiar.
+// Um último registro incompleto (driver encerrado no meio da escrita) é
+// ignorado e sinalizado por isTruncated().
+class CaptureReader {
+public:
+    CaptureReader(const char* data, qint64 size)
+        : m_data(data)
+        , m_size(size)
+    {
+        if (size < captureFileHeaderSize(1) || memcmp(data, CaptureMagic, sizeof(CaptureMagic)) != 0) return;
+        m_version = qFromLittleEndian<quint16>(data + 4);
+        m_valid = m_version >= 1 && m_version <= CaptureVersion && size >= captureFileHeaderSize(m_version);
+        if (m_valid) {
+            m_startEpochMs = qFromLittleEndian<quint64>(data + 8);
+            if (m_version >= 2) m_startClockNs = qFromLittleEndian<qint64>(data + 16);
+            m_pos = captureFileHeaderSize(m_version);
+        }
+    }
+
+    bool isValid() const { return m_valid; }
+    bool isTruncated() const { return m_truncated; }
+    quint16 version() const { return m_version; }
+    quint64 startEpochMs() const { return m_startEpochMs; }
+    qint64 startClockNs() const { return m_startClockNs; } // 0 na versão 1
+
+    void rewind() { m_pos = captureFileHeaderSize(m_version); m_truncated = false; }
+
+    bool next(CaptureRecord& rec)
+    {
+        if (!m_valid || m_pos >= m_size) return false;
+
+        const qint64 remaining = m_size - m_pos;
+        if (remaining < CaptureRecordHeaderSize + HeaderSize) {
+            m_truncated = true;
+            return false;
+        }
+
+        const char* p = m_data + m_pos;
+        const quint32 length = qFromLittleEndian<quint32>(p + CaptureRecordHeaderSize);
+        const qint64 packetSize = static_cast<qint64>(sizeof(quint32)) + length;
+        if (length < sizeof(quint16) || remaining - CaptureRecordHeaderSize < packetSize) {
+            m_truncated = true;
+            return false;
+        }
+
+        rec.timestampNs  = qFromLittleEndian<quint64>(p);
+        rec.clientId     = qFromLittleEndian<quint32>(p + sizeof(quint64));
+        rec.packet       = p + CaptureRecordHeaderSize;
+        rec.packetSize   = static_cast<int>(packetSize);
+        rec.type         = static_cast<MessageType>(qFromLittleEndian<quint16>(rec.packet + sizeof(quint32)));
+        rec.payload.data = rec.packet + HeaderSize;
+        rec.payload.size = rec.packetSize - HeaderSize;
+
+        m_pos += CaptureRecordHeaderSize + packetSize;
+        return true;
+    }
+
+private:
+    const char* m_data;
+    qint64 m_size;
+    qint64 m_pos = 0;
+    quint16 m_version = 0;
+    quint64 m_startEpochMs = 0;
+    qint64 m_startClockNs = 0;
+    bool m_valid = false;
+    bool m_truncated = false;
+};
+
+} // namespace DriverProtocol
+
+#endif // CAPTURE_FORMAT_H
@@ -0,0 +1,127 @@
+#ifndef DEVICE_FRAME_H
+#define DEVICE_FRAME_H
+
+#include <QtGlobal>
+#include <QtEndian>
+#include <QByteArray>
+#include <QVector>
+
+#include <cstring>
+
+#include "DriverFramer.h"
+
+namespace DriverProtocol {
+
+// Payload de SetDeviceFrame (little-endian):
+// [uint16 entryCount][uint16 reserved]
+// entryCount × [uint16 deviceId][uint16 zoneId][uint32 offset][uint32 count]
+// [RGB888 × total de LEDs]  <- bloco contíguo de cores
+//
+// offset/count são em LEDs dentro do bloco de cores. O bloco é o mesmo
+// frame "plano" usado por SetLedColors/SetLedColorsDelta, então deltas
+// subsequentes se aplicam a ele mantendo a tabela do último keyframe.
+constexpr int DeviceFrameHeaderSize = static_cast<int>(2 * sizeof(quint16));
+constexpr int DeviceFrameEntrySize  = static_cast<int>(2 * sizeof(quint16) + 2 * sizeof(quint32));
+
+struct DeviceFrameEntry {
+    quint16 deviceId = 0; // índice do RGBController no ResourceManager
+    quint16 zoneId   = 0; // índice da zona no controlador
+    quint32 offset   = 0; // primeiro LED no bloco de cores
+    quint32 count    = 0; // LEDs da zona
+
+    bool operator==(const DeviceFrameEntry& o) const
+    {
+        return deviceId == o.deviceId && zoneId == o.zoneId && offset == o.offset && count == o.count;
+    }
+    bool operator!=(const DeviceFrameEntry& o) const { return !(*this == o); }
+};
+
+// Serializa tabela + bloco de cores em 'out' (reutilizado entre chamadas).
+inline void encodeDeviceFrame(const QVector<DeviceFrameEntry>& entries, const QByteArray& colors, QByteArray& out)
+{
+    const int tableSize = DeviceFrameHeaderSize + entries.size() * DeviceFrameEntrySize;
+    out.resize(tableSize + colors.size());
+
+    char* p = out.data();
+    qToLittleEndian<quint16>(static_cast<quint16>(entries.size()), p);
+    qToLittleEndian<quint16>(0, p + sizeof(quint16));
+    p += DeviceFrameHeaderSize;
+
+    for (const DeviceFrameEntry& e : entries) {
+        qToLittleEndian<quint16>(e.deviceId, p);
+        qToLittleEndian<quint16>(e.zoneId,   p + 2);
+        qToLittleEndian<quint32>(e.offset,   p + 4);
+        qToLittleEndian<quint32>(e.count,    p + 8);
+        p += DeviceFrameEntrySize;
+    }
+
+    if (!colors.isEmpty()) {
+        memcpy(p, colors.constData(), static_cast<size_t>(colors.size()));
+    }
+}
+
+// Leitura sem cópia de um SetDeviceFrame. parse() valida a tabela inteira
+// contra o bloco de cores uma única vez; depois entry()/colors() são O(1).
+class DeviceFrameView {
+public:
+    bool parse(const PayloadView& payload)
+    {
+        m_table = nullptr;
+        m_entryCount = 0;
+        m_colors = PayloadView();
+
+        if (payload.size < DeviceFrameHeaderSize) return false;
+        const quint16 entryCount = qFromLittleEndian<quint16>(payload.data);
+        const int tableSize = DeviceFrameHeaderSize + entryCount * DeviceFrameEntrySize;
+        if (payload.size < tableSize) return false;
+
+        const int colorBytes = payload.size - tableSize;
+        if (colorBytes % 3 != 0) return false;
+        const quint64 ledCount = static_cast<quint64>(colorBytes / 3);
+
+        const char* table = payload.data + DeviceFrameHeaderSize;
+        for (int i = 0; i < entryCount; ++i) {
+            const char* e = table + i * DeviceFrameEntrySize;
+            const quint32 offset = qFromLittleEndian<quint32>(e + 4);
+            const quint32 count  = qFromLittleEndian<quint32>(e + 8);
+            if (static_cast<quint64>(offset) + count > ledCount) return false;
+        }
+
+        m_table = table;
+        m_entryCount = entryCount;
+        m_colors.data = payload.data + tableSize;
+        m_colors.size = colorBytes;
+        return true;
+    }
+
+    int entryCount() const { return m_entryCount; }
+    int ledCount() const { return m_colors.size / 3; }
+
+    DeviceFrameEntry entry(int i) const
+    {
+        const char* e = m_table + i * DeviceFrameEntrySize;
+        DeviceFrameEntry out;
+        out.deviceId = qFromLittleEndian<quint16>(e);
+        out.zoneId   = qFromLittleEndian<quint16>(e + 2);
+        out.offset   = qFromLittleEndian<quint32>(e + 4);
+        out.count    = qFromLittleEndian<quint32>(e + 8);
+        return out;
+    }
+
+    // Cores RGB888 da entrada i (aponta para dentro do payload)
+    const char* entryColors(int i) const
+    {
+        return m_colors.data + static_cast<size_t>(entry(i).offset) * 3;
+    }
+
+    const PayloadView& colors() const { return m_colors; }
+
+private:
+    const char* m_table = nullptr;
+    int m_entryCount = 0;
+    PayloadView m_colors;
+};
+
+} // namespace DriverProtocol
+
+#endif // DEVICE_FRAME_H
@@ -0,0 +1,159 @@
+#ifndef DRIVER_FRAMER_H
+#define DRIVER_FRAMER_H
+
+#include <QtGlobal>
+#include <QtEndian>
+#include <QByteArray>
+
+#include <cstring>
+
+#include "DriverProtocol.h"
+
+namespace DriverProtocol {
+
+// Visão não-proprietária de um payload. Aponta para dentro do buffer do
+// Framer e só é válida durante o callback de consume().
+struct PayloadView {
+    const char* data = nullptr;
+    int size = 0;
+
+    bool isEmpty() const { return size <= 0; }
+    const uchar* bytes() const { return reinterpret_cast<const uchar*>(data); }
+    QByteArray toByteArray() const { return QByteArray(data, size); }
+};
+
+// Framer sobre uma arena reutilizável.
+//
+// Os bytes recebidos são escritos diretamente no fim da arena
+// (prepareWrite/commitWrite) e consume() percorre todos os frames completos
+// em uma única passada, entregando views para o handler. Nada é copiado por
+// mensagem: ao final do lote, apenas o frame incompleto restante (se houver)
+// é movido para o início da arena, no máximo uma vez por leitura do socket.
+// O formato no fio é o mesmo de pack()/tryUnpack().
+//
+// Um cabeçalho com length menor que o campo type ou maior que
+// maxFrameSize() deixa o framer em erro: o stream perdeu o sincronismo e
+// a conexão deve ser descartada.
+class Framer {
+public:
+    enum class Error {
+        None,
+        FrameTooShort, // length < sizeof(type)
+        FrameTooLarge  // length > maxFrameSize
+    };
+
+    explicit Framer(int initialCapacity = 64 * 1024)
+    {
+        m_storage.resize(initialCapacity);
+    }
+
+    // Garante ao menos 'n' bytes contíguos livres no fim da arena e retorna
+    // o ponteiro de escrita. Deve ser seguido de commitWrite().
+    char* prepareWrite(int n)
+    {
+        if (m_storage.size() - m_write < n) {
+            compact();
+            if (m_storage.size() - m_write < n) {
+                m_storage.resize(qMax(m_storage.size() * 2, m_write + n));
+            }
+        }
+        return m_storage.data() + m_write;
+    }
+
+    void commitWrite(int n)
+    {
+        m_write += n;
+    }
+
+    void append(const char* data, int n)
+    {
+        if (n <= 0) return;
+        memcpy(prepareWrite(n), data, static_cast<size_t>(n));
+        commitWrite(n);
+    }
+
+    // Processa todos os frames completos presentes na arena.
+    // Handler: void(MessageType type, const PayloadView& payload)
+    // Retorna a quantidade de frames entregues.
+    template <typename Handler>
+    int consume(Handler&& handler)
+    {
+        if (m_error != Error::None) return 0;
+
+        const char* base = m_storage.constData();
+        int frames = 0;
+
+        while (m_write - m_read >= HeaderSize) {
+            const char* p = base + m_read;
+            const quint32 length = qFromLittleEndian<quint32>(p);
+            const quint16 type   = qFromLittleEndian<quint16>(p + sizeof(quint32));
+
+            if (length < sizeof(quint16)) {
+                m_error = Error::FrameTooShort;
+                break;
+            }
+            if (length > m_maxFrameSize) {
+                m_error = Error::FrameTooLarge;
+                break;
+            }
+
+            const qint64 totalNeeded = static_cast<qint64>(sizeof(quint32)) + length;
+            if (m_write - m_read < totalNeeded) {
+                break; // aguardar mais dados
+            }
+
+            PayloadView payload;
+            payload.data = p + HeaderSize;
+            payload.size = static_cast<int>(length) - static_cast<int>(sizeof(quint16));
+
+            m_read += static_cast<int>(totalNeeded);
+            ++frames;
+            handler(static_cast<MessageType>(type), payload);
+        }
+
+        // Arena vazia: volta ao início sem mover nada
+        if (m_read == m_write) {
+            m_read = 0;
+            m_write = 0;
+        }
+        return frames;
+    }
+
+    Error error() const { return m_error; }
+    bool hasError() const { return m_error != Error::None; }
+
+    quint32 maxFrameSize() const { return m_maxFrameSize; }
+    void setMaxFrameSize(quint32 bytes) { m_maxFrameSize = bytes; }
+
+    int pendingBytes() const { return m_write - m_read; }
+    int capacity() const { return m_storage.size(); }
+
+    void clear()
+    {
+        m_read = 0;
+        m_write = 0;
+        m_error = Error::None;
+    }
+
+private:
+    QByteArray m_storage;
+    int m_read = 0;  // início do primeiro frame não consumido
+    int m_write = 0; // fim dos dados válidos
+    quint32 m_maxFrameSize = DefaultMaxFrameSize;
+    Error m_error = Error::None;
+
+    void compact()
+    {
+        if (m_read == 0) return;
+        const int pending = m_write - m_read;
+        if (pending > 0) {
+            memmove(m_storage.data(), m_storage.constData() + m_read, static_cast<size_t>(pending));
+        }
+        m_read = 0;
+        m_write = pending;
+    }
+};
+
+} // namespace DriverProtocol
+
+#endif // DRIVER_FRAMER_H
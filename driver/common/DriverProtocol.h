@@ -2,21 +2,44 @@
 #define DRIVER_PROTOCOL_H
 
 #include <QtGlobal>
+#include <QtEndian>
 #include <QByteArray>
-#include <QDataStream>
+
+#include <cstring>
 
 namespace DriverProtocol {
 
 // Mensagens suportadas entre Plugin <-> Driver
 enum class MessageType : quint16 {
-    Ping                = 1,
-    Pong                = 2,
+    Ping                = 1,  // payload: vazio ou [int64 sentNs]
+    Pong                = 2,  // payload: vazio ou [int64 sentNs ecoado][int64 instante no driver]
+    Hello               = 3,  // payload: Capabilities (ver Handshake.h), plugin -> driver
+    HelloAck            = 4,  // payload: Capabilities negociadas para a conexão
     SetLedColors        = 10, // payload: array de RGB (RGB888)
     SetBrightness       = 11, // payload: 1 float [0..1]
+    SetLedColorsDelta   = 12, // payload: runs alterados desde o último frame (ver FrameDelta.h)
+    RequestKeyframe     = 13, // payload: vazio (driver -> plugin: referência inválida)
+    SetDeviceFrame      = 14, // payload: tabela device/zona + bloco RGB888 (ver DeviceFrame.h)
+    TimedFrame          = 15, // payload: FrameStamp + [uint16 type][frame] (ver FrameTiming.h)
+    FrameAck            = 16, // payload: [uint32 seq][int64 sentNs][int64 receivedNs], driver -> plugin
     GetStatus           = 20, // payload: vazio
-    StatusResponse      = 21  // payload: string/JSON curto
+    StatusResponse      = 21, // payload: string/JSON curto
+    GetStats            = 22, // payload: vazio
+    StatsResponse       = 23, // payload: DriverStats binário da conexão (ver DriverStats.h)
+    OpenSharedTransport = 30, // payload: [uint16 len][nome UTF-8] do anel (ver SharedFrameRing.h)
+    SharedTransportAck  = 31, // payload: [uint8 aceito]
+    FrameDoorbell       = 32  // payload: [uint64 seq] último frame publicado no anel
 };
 
+// Mensagens de frame de LED (podem trafegar pelo anel compartilhado)
+inline bool isFrameMessage(MessageType type)
+{
+    return type == MessageType::SetLedColors
+        || type == MessageType::SetLedColorsDelta
+        || type == MessageType::SetDeviceFrame
+        || type == MessageType::TimedFrame;
+}
+
 // Cabeçalho binário (little-endian)
 // [uint32 length][uint16 type]
 // length = tamanho de (type + payload)
@@ -25,41 +48,73 @@ struct Header {
     quint16 type;     // MessageType
 };
 
-inline QByteArray pack(MessageType type, const QByteArray& payload)
-{
-    QByteArray buffer;
-    QDataStream out(&buffer, QIODevice::WriteOnly);
-    out.setByteOrder(QDataStream::LittleEndian);
+// Tamanho fixo do cabeçalho no fio
+constexpr int HeaderSize = static_cast<int>(sizeof(quint32) + sizeof(quint16));
 
-    Header h;
-    h.length = static_cast<quint32>(sizeof(quint16) + payload.size());
-    h.type   = static_cast<quint16>(type);
+// Maior frame (type + payload) aceito por padrão; headers acima disso são
+// tratados como corrupção do stream
+constexpr quint32 DefaultMaxFrameSize = 16 * 1024 * 1024;
 
-    out << h.length;
-    out << h.type;
-    if (!payload.isEmpty()) {
-        out.writeRawData(payload.constData(), payload.size());
+// Escreve o cabeçalho em 'dst' (HeaderSize bytes)
+inline void writeHeader(char* dst, MessageType type, int payloadSize)
+{
+    qToLittleEndian<quint32>(static_cast<quint32>(sizeof(quint16) + payloadSize), dst);
+    qToLittleEndian<quint16>(static_cast<quint16>(type), dst + sizeof(quint32));
+}
+
+// Acrescenta um pacote completo ao fim de 'out'. Com 'out' reutilizado
+// entre chamadas (resize(0) + capacidade reservada) não há alocação.
+inline void packInto(QByteArray& out, MessageType type, const char* payload, int payloadSize)
+{
+    const int at = out.size();
+    out.resize(at + HeaderSize + payloadSize);
+    char* p = out.data() + at;
+    writeHeader(p, type, payloadSize);
+    if (payloadSize > 0) {
+        memcpy(p + HeaderSize, payload, static_cast<size_t>(payloadSize));
     }
+}
+
+inline QByteArray pack(MessageType type, const QByteArray& payload)
+{
+    QByteArray buffer;
+    packInto(buffer, type, payload.constData(), payload.size());
     return buffer;
 }
 
-inline bool tryUnpack(QByteArray& inoutBuffer, MessageType& outType, QByteArray& outPayload)
+// Caminho legado (cópia + remove por mensagem); o servidor usa Framer.
+//
+// O pacote ocupa sizeof(uint32) + length bytes: length já inclui o campo
+// type. A versão original somava o type de novo (6 + length), consumia
+// dois bytes a mais por pacote e perdia o sincronismo a partir do segundo
+// pacote de um mesmo buffer. O formato no fio (pack/writeHeader) não mudou.
+//
+// Como no Framer, um length menor que o campo type ou maior que
+// DefaultMaxFrameSize é corrupção do stream: nada é consumido, retorna
+// false e *outCorrupt (se dado) fica true; a conexão deve ser descartada.
+inline bool tryUnpack(QByteArray& inoutBuffer, MessageType& outType, QByteArray& outPayload,
+                      bool* outCorrupt = nullptr)
 {
+    if (outCorrupt) {
+        *outCorrupt = false;
+    }
+
     // Necessário no mínimo o header
-    if (inoutBuffer.size() < static_cast<int>(sizeof(quint32) + sizeof(quint16))) {
+    if (inoutBuffer.size() < HeaderSize) {
         return false;
     }
 
-    QDataStream in(inoutBuffer);
-    in.setByteOrder(QDataStream::LittleEndian);
-
-    quint32 length = 0; // type + payload
-    quint16 type   = 0;
+    const quint32 length = qFromLittleEndian<quint32>(inoutBuffer.constData()); // type + payload
+    const quint16 type   = qFromLittleEndian<quint16>(inoutBuffer.constData() + sizeof(quint32));
 
-    in >> length;
-    in >> type;
+    if (length < sizeof(quint16) || length > DefaultMaxFrameSize) {
+        if (outCorrupt) {
+            *outCorrupt = true;
+        }
+        return false;
+    }
 
-    const int totalNeeded = static_cast<int>(sizeof(quint32) + sizeof(quint16) + length);
+    const int totalNeeded = static_cast<int>(sizeof(quint32) + length);
     if (inoutBuffer.size() < totalNeeded) {
         return false; // aguardar mais dados
     }
@@ -67,7 +122,7 @@ inline bool tryUnpack(QByteArray& inoutBuffer, MessageType& outType, QByteArray&
     outType = static_cast<MessageType>(type);
     const int payloadSize = static_cast<int>(length) - static_cast<int>(sizeof(quint16));
     if (payloadSize > 0) {
-        outPayload = inoutBuffer.mid(sizeof(quint32) + sizeof(quint16), payloadSize);
+        outPayload = inoutBuffer.mid(HeaderSize, payloadSize);
     } else {
         outPayload.clear();
     }
@@ -0,0 +1,50 @@
+#ifndef DRIVER_STATS_H
+#define DRIVER_STATS_H
+
+#include <QtGlobal>
+#include <QByteArray>
+
+#include "DriverFramer.h"
+#include "MessageSchema.h"
+
+namespace DriverProtocol {
+
+// Contadores de uma conexão, resposta de GetStats. Layout fixo e pequeno
+// (80 bytes de payload) para consulta em alta frequência sem o custo do
+// JSON do StatusResponse. Tempos em nanossegundos; percentis são o limite
+// superior do bucket log2 correspondente.
+struct DriverStats {
+    quint64 framesIn         = 0; // mensagens de frame recebidas
+    quint64 bytesIn          = 0;
+    quint64 framesApplied    = 0; // entregues ao estado de saída
+    quint64 framesSuperseded = 0; // substituídos por um frame mais novo (coalescência)
+    quint64 framesDropped    = 0; // descartados com a fila do consumidor cheia
+    quint32 deltasRejected   = 0;
+    quint32 framesPerSec     = 0;
+    quint32 bytesPerSec      = 0;
+    quint32 parseP50Ns       = 0; // decodificação por mensagem no worker
+    quint32 parseP99Ns       = 0;
+    quint32 latencyP50Ns     = 0; // recepção -> aplicação no consumidor
+    quint32 latencyP99Ns     = 0;
+    quint32 maxBacklogBytes  = 0; // maior leitura pendente no socket
+    quint32 maxQueueDepth    = 0; // maior profundidade da fila do worker
+    quint32 framesLate       = 0; // TimedFrame recebido depois do seu instante de apresentação
+
+    int packInto(QByteArray& out) const
+    {
+        return StatsResponseMsg::packInto(out, framesIn, bytesIn, framesApplied, framesSuperseded, framesDropped,
+                                          deltasRejected, framesPerSec, bytesPerSec, parseP50Ns, parseP99Ns,
+                                          latencyP50Ns, latencyP99Ns, maxBacklogBytes, maxQueueDepth, framesLate);
+    }
+
+    bool decode(const PayloadView& payload)
+    {
+        return StatsResponseMsg::decode(payload, framesIn, bytesIn, framesApplied, framesSuperseded, framesDropped,
+                                        deltasRejected, framesPerSec, bytesPerSec, parseP50Ns, parseP99Ns,
+                                        latencyP50Ns, latencyP99Ns, maxBacklogBytes, maxQueueDepth, framesLate);
+    }
+};
+
+} // namespace DriverProtocol
+
+#endif // DRIVER_STATS_H
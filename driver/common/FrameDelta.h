@@ -0,0 +1,127 @@
+#ifndef FRAME_DELTA_H
+#define FRAME_DELTA_H
+
+#include <QtGlobal>
+#include <QtEndian>
+#include <QByteArray>
+
+#include <cstring>
+
+#include "DriverFramer.h"
+
+namespace DriverProtocol {
+
+// Payload de SetLedColorsDelta (little-endian):
+// [uint32 ledCount][uint16 runCount]
+// runCount × ([uint32 start][uint16 count][count × RGB888])
+//
+// ledCount é o tamanho (em LEDs) do frame de referência ao qual o delta se
+// aplica; se não bater com a referência do receptor o delta é descartado e
+// um RequestKeyframe é devolvido.
+constexpr int DeltaHeaderSize    = static_cast<int>(sizeof(quint32) + sizeof(quint16));
+constexpr int DeltaRunHeaderSize = static_cast<int>(sizeof(quint32) + sizeof(quint16));
+constexpr int DeltaMaxRunLength  = 0xFFFF;
+
+// Lacunas de até 2 LEDs iguais são absorvidas pelo run corrente: custam
+// 6 bytes, o mesmo que o cabeçalho de um run novo.
+constexpr int DeltaRunMergeGap = DeltaRunHeaderSize / 3;
+
+// Codifica 'next' como delta relativo a 'prev' em 'out' (reutilizado).
+// Retorna false se os frames têm tamanhos diferentes ou se o delta não
+// ficaria menor que o keyframe; nesse caso o chamador envia SetLedColors.
+inline bool encodeDelta(const QByteArray& prev, const QByteArray& next, QByteArray& out)
+{
+    if (prev.size() != next.size() || next.size() % 3 != 0) {
+        return false;
+    }
+
+    const int ledCount = next.size() / 3;
+    const char* a = prev.constData();
+    const char* b = next.constData();
+
+    out.resize(DeltaHeaderSize);
+    quint16 runCount = 0;
+
+    int i = 0;
+    while (i < ledCount) {
+        if (memcmp(a + i * 3, b + i * 3, 3) == 0) {
+            ++i;
+            continue;
+        }
+
+        // Estende o run enquanto houver diferenças ou lacunas curtas
+        const int start = i;
+        int end = i + 1; // exclusivo
+        int probe = end;
+        while (probe < ledCount && probe - start < DeltaMaxRunLength) {
+            if (memcmp(a + probe * 3, b + probe * 3, 3) != 0) {
+                end = ++probe;
+            } else if (probe - end < DeltaRunMergeGap) {
+                ++probe;
+            } else {
+                break;
+            }
+        }
+
+        const int count = end - start;
+        const int at = out.size();
+        if (at + DeltaRunHeaderSize + count * 3 >= next.size() || runCount == 0xFFFF) {
+            return false; // delta não compensa
+        }
+        out.resize(at + DeltaRunHeaderSize + count * 3);
+        char* p = out.data() + at;
+        qToLittleEndian<quint32>(static_cast<quint32>(start), p);
+        qToLittleEndian<quint16>(static_cast<quint16>(count), p + sizeof(quint32));
+        memcpy(p + DeltaRunHeaderSize, b + start * 3, static_cast<size_t>(count) * 3);
+        ++runCount;
+
+        i = end;
+    }
+
+    char* h = out.data();
+    qToLittleEndian<quint32>(static_cast<quint32>(ledCount), h);
+    qToLittleEndian<quint16>(runCount, h + sizeof(quint32));
+    return out.size() < next.size();
+}
+
+// Aplica um delta sobre o frame de referência 'ref' (in-place).
+// Valida todo o payload antes de alterar a referência.
+inline bool applyDelta(QByteArray& ref, const PayloadView& payload)
+{
+    if (payload.size < DeltaHeaderSize) return false;
+
+    const char* p = payload.data;
+    const quint32 ledCount = qFromLittleEndian<quint32>(p);
+    const quint16 runCount = qFromLittleEndian<quint16>(p + sizeof(quint32));
+    if (ref.isEmpty() || static_cast<qint64>(ledCount) * 3 != ref.size()) {
+        return false;
+    }
+
+    // 1ª passada: validação de limites
+    int pos = DeltaHeaderSize;
+    for (quint16 r = 0; r < runCount; ++r) {
+        if (payload.size - pos < DeltaRunHeaderSize) return false;
+        const quint32 start = qFromLittleEndian<quint32>(p + pos);
+        const quint16 count = qFromLittleEndian<quint16>(p + pos + sizeof(quint32));
+        if (static_cast<quint64>(start) + count > ledCount) return false;
+        pos += DeltaRunHeaderSize;
+        if (payload.size - pos < count * 3) return false;
+        pos += count * 3;
+    }
+
+    // 2ª passada: aplicação
+    char* dst = ref.data();
+    pos = DeltaHeaderSize;
+    for (quint16 r = 0; r < runCount; ++r) {
+        const quint32 start = qFromLittleEndian<quint32>(p + pos);
+        const quint16 count = qFromLittleEndian<quint16>(p + pos + sizeof(quint32));
+        pos += DeltaRunHeaderSize;
+        memcpy(dst + static_cast<size_t>(start) * 3, p + pos, static_cast<size_t>(count) * 3);
+        pos += count * 3;
+    }
+    return true;
+}
+
+} // namespace DriverProtocol
+
+#endif // FRAME_DELTA_H
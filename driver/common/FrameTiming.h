@@ -0,0 +1,75 @@
+#ifndef FRAME_TIMING_H
+#define FRAME_TIMING_H
+
+#include <QtGlobal>
+#include <QtEndian>
+#include <QByteArray>
+
+#include <chrono>
+#include <cstring>
+
+#include "DriverProtocol.h"
+#include "DriverFramer.h"
+
+namespace DriverProtocol {
+
+// Relógio de apresentação: monotônico do sistema (CLOCK_MONOTONIC no Linux,
+// QueryPerformanceCounter no Windows), o mesmo para plugin e driver na
+// mesma máquina. Os timestamps de TimedFrame são absolutos neste relógio.
+inline qint64 presentationClockNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Payload de TimedFrame (little-endian):
+// [uint32 seq][int64 sentNs][int64 presentAtNs][uint16 type][payload do frame]
+//
+// O frame interno (SetLedColors, SetLedColorsDelta ou SetDeviceFrame) é
+// decodificado como se tivesse chegado sozinho. seq cresce 1 por frame
+// enviado na conexão e sentNs é o instante do envio; o driver devolve ambos
+// em FrameAck com o instante da recepção, o que dá ao plugin a latência de
+// cada frame e a detecção de perdas/reordenação. presentAtNs diz quando o
+// driver deve exibir o frame (0 = assim que possível): frames no futuro
+// ficam enfileirados, frames que chegam depois do seu instante são
+// descartados.
+struct FrameStamp {
+    quint32 seq = 0;
+    qint64 sentNs = 0;
+    qint64 presentAtNs = 0;
+};
+
+constexpr int TimedFrameHeaderSize = static_cast<int>(sizeof(quint32) + 2 * sizeof(qint64) + sizeof(quint16));
+
+// Serializa o envelope em 'out' (reutilizado entre chamadas)
+inline void encodeTimedFrame(const FrameStamp& stamp, MessageType type, const char* payload, int payloadSize, QByteArray& out)
+{
+    out.resize(TimedFrameHeaderSize + payloadSize);
+    char* p = out.data();
+    qToLittleEndian<quint32>(stamp.seq, p);
+    qToLittleEndian<qint64>(stamp.sentNs, p + 4);
+    qToLittleEndian<qint64>(stamp.presentAtNs, p + 12);
+    qToLittleEndian<quint16>(static_cast<quint16>(type), p + 20);
+    if (payloadSize > 0) {
+        memcpy(p + TimedFrameHeaderSize, payload, static_cast<size_t>(payloadSize));
+    }
+}
+
+// Leitura sem cópia; 'frame' aponta para dentro do payload. Envelopes
+// aninhados ou com conteúdo que não é frame de LED são rejeitados.
+inline bool parseTimedFrame(const PayloadView& payload, FrameStamp& stamp, MessageType& type, PayloadView& frame)
+{
+    if (payload.size < TimedFrameHeaderSize) return false;
+    stamp.seq         = qFromLittleEndian<quint32>(payload.data);
+    stamp.sentNs      = qFromLittleEndian<qint64>(payload.data + 4);
+    stamp.presentAtNs = qFromLittleEndian<qint64>(payload.data + 12);
+    type = static_cast<MessageType>(qFromLittleEndian<quint16>(payload.data + 20));
+    if (!isFrameMessage(type) || type == MessageType::TimedFrame) return false;
+    frame.data = payload.data + TimedFrameHeaderSize;
+    frame.size = payload.size - TimedFrameHeaderSize;
+    return true;
+}
+
+} // namespace DriverProtocol
+
+#endif // FRAME_TIMING_H
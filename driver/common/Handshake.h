@@ -0,0 +1,98 @@
+#ifndef HANDSHAKE_H
+#define HANDSHAKE_H
+
+#include <QtGlobal>
+#include <QtEndian>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include "DriverFramer.h"
+#include "MessageSchema.h"
+
+namespace DriverProtocol {
+
+// Versão do protocolo anunciada no Hello. Conexões sem Hello (plugins ou
+// drivers antigos) operam como versão 0: apenas SetLedColors pelo socket.
+constexpr quint16 ProtocolVersion = 1;
+
+// Codificações de frame de LED (bitmask)
+enum Encoding : quint32 {
+    EncodingFullFrame   = 1u << 0, // SetLedColors
+    EncodingDelta       = 1u << 1, // SetLedColorsDelta
+    EncodingDeviceFrame = 1u << 2, // SetDeviceFrame
+    EncodingTimedFrame  = 1u << 3  // TimedFrame (apresentação agendada)
+};
+
+// Transportes de frame (bitmask)
+enum Transport : quint32 {
+    TransportSocket       = 1u << 0,
+    TransportSharedMemory = 1u << 1  // SharedFrameRing + FrameDoorbell
+};
+
+// Payload de Hello/HelloAck (little-endian):
+// [uint16 version][uint32 maxFrameSize][uint32 encodings][uint32 transports]
+// No HelloAck os campos já são o conjunto negociado para a conexão.
+struct Capabilities {
+    quint16 version      = 0;
+    quint32 maxFrameSize = DefaultMaxFrameSize;
+    quint32 encodings    = EncodingFullFrame;
+    quint32 transports   = TransportSocket;
+
+    bool has(Encoding e) const { return (encodings & e) != 0; }
+    bool has(Transport t) const { return (transports & t) != 0; }
+
+    // Hello e HelloAck compartilham o mesmo layout
+    int packInto(QByteArray& out, MessageType type) const
+    {
+        return type == MessageType::HelloAck
+            ? HelloAckMsg::packInto(out, version, maxFrameSize, encodings, transports)
+            : HelloMsg::packInto(out, version, maxFrameSize, encodings, transports);
+    }
+
+    bool decode(const PayloadView& payload)
+    {
+        return HelloMsg::decode(payload, version, maxFrameSize, encodings, transports);
+    }
+
+    // Conjunto comum entre os dois lados. Full frame e socket são sempre
+    // suportados, garantindo um caminho de fallback.
+    static Capabilities negotiate(const Capabilities& local, const Capabilities& remote)
+    {
+        Capabilities c;
+        c.version      = qMin(local.version, remote.version);
+        c.maxFrameSize = qMin(local.maxFrameSize, remote.maxFrameSize);
+        c.encodings    = (local.encodings & remote.encodings) | EncodingFullFrame;
+        c.transports   = (local.transports & remote.transports) | TransportSocket;
+        return c;
+    }
+
+    // Descrição curta para logs/status, ex.: "v1 device+delta+timed shm"
+    QString describe() const
+    {
+        QStringList enc;
+        if (has(EncodingDeviceFrame)) enc << "device";
+        if (has(EncodingDelta))       enc << "delta";
+        if (enc.isEmpty())            enc << "full";
+        if (has(EncodingTimedFrame))  enc << "timed";
+        return QString("v%1 %2 %3")
+            .arg(version)
+            .arg(enc.join("+"))
+            .arg(has(TransportSharedMemory) ? "shm" : "socket");
+    }
+};
+
+// Tudo que este build implementa
+inline Capabilities localCapabilities()
+{
+    Capabilities c;
+    c.version      = ProtocolVersion;
+    c.maxFrameSize = DefaultMaxFrameSize;
+    c.encodings    = EncodingFullFrame | EncodingDelta | EncodingDeviceFrame | EncodingTimedFrame;
+    c.transports   = TransportSocket | TransportSharedMemory;
+    return c;
+}
+
+} // namespace DriverProtocol
+
+#endif // HANDSHAKE_H
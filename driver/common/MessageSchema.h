@@ -0,0 +1,105 @@
+#ifndef MESSAGE_SCHEMA_H
+#define MESSAGE_SCHEMA_H
+
+#include <QtGlobal>
+#include <QtEndian>
+#include <QByteArray>
+
+#include <cstring>
+
+#include "DriverProtocol.h"
+#include "DriverFramer.h"
+
+namespace DriverProtocol {
+
+// Leitura/escrita little-endian de campos escalares de layout fixo.
+namespace Wire {
+
+template <typename T>
+inline char* put(char* p, T value)
+{
+    qToLittleEndian<T>(value, p);
+    return p + sizeof(T);
+}
+
+inline char* put(char* p, float value)
+{
+    quint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return put<quint32>(p, bits);
+}
+
+template <typename T>
+inline const char* get(const char* p, T& value)
+{
+    value = qFromLittleEndian<T>(p);
+    return p + sizeof(T);
+}
+
+inline const char* get(const char* p, float& value)
+{
+    const quint32 bits = qFromLittleEndian<quint32>(p);
+    memcpy(&value, &bits, sizeof(value));
+    return p + sizeof(quint32);
+}
+
+} // namespace Wire
+
+// Descrição em tempo de compilação de uma mensagem de payload fixo.
+//
+// O tamanho do pacote é constexpr e cada campo é escrito com um store
+// little-endian direto, sem QDataStream. packInto() acrescenta o pacote a um
+// buffer fornecido pelo chamador; decode() é o decodificador gerado a partir
+// do mesmo schema, usado pelo WDLDriverServer.
+template <MessageType Type, typename... Fields>
+struct MessageSchema {
+    static constexpr MessageType type = Type;
+    static constexpr int payloadSize = static_cast<int>((0 + ... + sizeof(Fields)));
+    static constexpr int packetSize  = HeaderSize + payloadSize;
+
+    static int packInto(QByteArray& out, Fields... values)
+    {
+        const int at = out.size();
+        out.resize(at + packetSize);
+        char* p = out.data() + at;
+        writeHeader(p, Type, payloadSize);
+        p += HeaderSize;
+        ((p = Wire::put(p, values)), ...);
+        Q_UNUSED(p);
+        return packetSize;
+    }
+
+    static bool decode(const PayloadView& payload, Fields&... values)
+    {
+        if (payload.size < payloadSize) return false;
+        const char* p = payload.data;
+        ((p = Wire::get(p, values)), ...);
+        Q_UNUSED(p);
+        return true;
+    }
+};
+
+using PingMsg               = MessageSchema<MessageType::Ping>;
+using PongMsg               = MessageSchema<MessageType::Pong>;
+// Ping com horário: o Pong ecoa sentNs e acrescenta o relógio do driver
+using PingStampedMsg        = MessageSchema<MessageType::Ping, qint64>;
+using PongStampedMsg        = MessageSchema<MessageType::Pong, qint64, qint64>;
+using FrameAckMsg           = MessageSchema<MessageType::FrameAck, quint32, qint64, qint64>;
+using RequestKeyframeMsg    = MessageSchema<MessageType::RequestKeyframe>;
+using GetStatusMsg          = MessageSchema<MessageType::GetStatus>;
+using SetBrightnessMsg      = MessageSchema<MessageType::SetBrightness, float>;
+using SharedTransportAckMsg = MessageSchema<MessageType::SharedTransportAck, quint8>;
+using FrameDoorbellMsg      = MessageSchema<MessageType::FrameDoorbell, quint64>;
+// version, maxFrameSize, encodings, transports (ver Handshake.h)
+using HelloMsg              = MessageSchema<MessageType::Hello, quint16, quint32, quint32, quint32>;
+using HelloAckMsg           = MessageSchema<MessageType::HelloAck, quint16, quint32, quint32, quint32>;
+using GetStatsMsg           = MessageSchema<MessageType::GetStats>;
+// Campos de DriverStats, na ordem da struct (ver DriverStats.h)
+using StatsResponseMsg      = MessageSchema<MessageType::StatsResponse,
+                                            quint64, quint64, quint64, quint64, quint64,
+                                            quint32, quint32, quint32, quint32, quint32,
+                                            quint32, quint32, quint32, quint32, quint32>;
+
+} // namespace DriverProtocol
+
+#endif // MESSAGE_SCHEMA_H
@@ -0,0 +1,254 @@
+#include "SharedFrameRing.h"
+
+#include <cstring>
+#include <new>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <string>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DriverProtocol {
+
+namespace {
+
+constexpr quint64 CacheLine = 64;
+
+quint64 alignUp(quint64 v)
+{
+    return (v + CacheLine - 1) & ~(CacheLine - 1);
+}
+
+#ifndef Q_OS_WIN
+// shm_open exige nome iniciando com '/'
+QByteArray posixName(const QString& name)
+{
+    return "/" + name.toUtf8();
+}
+#endif
+
+} // namespace
+
+SharedFrameRing::~SharedFrameRing()
+{
+    close();
+}
+
+quint64 SharedFrameRing::regionSize(quint32 slotCount, quint32 slotSize)
+{
+    const quint64 stride = alignUp(sizeof(SlotHeader) + slotSize);
+    return alignUp(sizeof(RingHeader)) + stride * slotCount;
+}
+
+SharedFrameRing::SlotHeader* SharedFrameRing::slotAt(quint64 seq) const
+{
+    const quint64 stride = alignUp(sizeof(SlotHeader) + m_slotSize);
+    const quint64 index  = seq % m_slotCount;
+    char* base = reinterpret_cast<char*>(m_header) + alignUp(sizeof(RingHeader));
+    return reinterpret_cast<SlotHeader*>(base + index * stride);
+}
+
+bool SharedFrameRing::create(const QString& name, quint32 slotCount, quint32 slotSize)
+{
+    close();
+    if (slotCount == 0 || slotSize == 0 || slotSize > DefaultMaxFrameSize) return false;
+
+    const quint64 size = regionSize(slotCount, slotSize);
+    if (!mapRegion(name, size, true)) return false;
+
+    m_owner = true;
+    m_name = name;
+    m_slotCount = slotCount;
+    m_slotSize = slotSize;
+
+    // Região recém-criada: inicializar cabeçalho e slots
+    memset(static_cast<void*>(m_header), 0, static_cast<size_t>(size));
+    m_header->magic     = Magic;
+    m_header->version   = Version;
+    m_header->slotCount = slotCount;
+    m_header->slotSize  = slotSize;
+    new (&m_header->writeSeq) std::atomic<quint64>(0);
+    for (quint32 i = 0; i < slotCount; ++i) {
+        new (&slotAt(i)->seq) std::atomic<quint64>(0);
+    }
+    return true;
+}
+
+bool SharedFrameRing::open(const QString& name)
+{
+    close();
+
+    // Mapear só o cabeçalho para descobrir a geometria; cada campo é lido
+    // uma única vez (o escritor pode alterá-lo a qualquer momento)
+    if (!mapRegion(name, sizeof(RingHeader), false)) return false;
+    const quint32 magic     = m_header->magic;
+    const quint32 version   = m_header->version;
+    const quint32 slotCount = m_header->slotCount;
+    const quint32 slotSize  = m_header->slotSize;
+    close();
+
+    const bool valid = magic == Magic && version == Version && slotCount > 0
+                    && slotSize > 0 && slotSize <= DefaultMaxFrameSize;
+    if (!valid || !mapRegion(name, regionSize(slotCount, slotSize), false)) return false;
+
+    m_owner = false;
+    m_name = name;
+    m_slotCount = slotCount;
+    m_slotSize = slotSize;
+    // Começa a ler a partir do que for publicado depois da abertura
+    m_readSeq = m_header->writeSeq.load(std::memory_order_acquire);
+    m_dropped = 0;
+    return true;
+}
+
+quint64 SharedFrameRing::publish(quint16 type, const char* data, int size)
+{
+    if (!m_header || size < 0 || static_cast<quint32>(size) > m_slotSize) {
+        return 0;
+    }
+
+    const quint64 seq = m_header->writeSeq.load(std::memory_order_relaxed) + 1;
+    SlotHeader* slot = slotAt(seq);
+
+    // Seqlock: ímpar enquanto escreve
+    slot->seq.store(2 * seq - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->type = type;
+    slot->size = static_cast<quint32>(size);
+    if (size > 0) {
+        memcpy(reinterpret_cast<char*>(slot) + sizeof(SlotHeader), data, static_cast<size_t>(size));
+    }
+
+    slot->seq.store(2 * seq, std::memory_order_release);
+    m_header->writeSeq.store(seq, std::memory_order_release);
+    return seq;
+}
+
+bool SharedFrameRing::read(quint64 seq, quint16& outType, QByteArray& scratch) const
+{
+    if (!m_header || seq == 0) return false;
+
+    const SlotHeader* slot = slotAt(seq);
+    const quint64 before = slot->seq.load(std::memory_order_acquire);
+    if (before != 2 * seq) return false;
+
+    const quint32 size = slot->size;
+    if (size > m_slotSize) return false;
+
+    outType = slot->type;
+    scratch.resize(static_cast<int>(size));
+    if (size > 0) {
+        memcpy(scratch.data(), reinterpret_cast<const char*>(slot) + sizeof(SlotHeader), size);
+    }
+
+    // Escritor não pode ter tocado no slot durante a cópia
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot->seq.load(std::memory_order_relaxed) == before;
+}
+
+#ifdef Q_OS_WIN
+
+bool SharedFrameRing::mapRegion(const QString& name, quint64 size, bool create)
+{
+    const std::wstring wname = (QStringLiteral("Local\\") + name).toStdWString();
+    HANDLE mapping = create
+        ? CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                             static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFFu),
+                             wname.c_str())
+        : OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, wname.c_str());
+    if (!mapping) return false;
+
+    // Nome já existente: CreateFileMapping abre a seção de outro processo
+    // em vez de falhar (equivalente ao O_EXCL do caminho POSIX)
+    if (create && GetLastError() == ERROR_ALREADY_EXISTS) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, static_cast<SIZE_T>(size));
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_mapping = mapping;
+    m_header = static_cast<RingHeader*>(view);
+    m_mappedSize = size;
+    return true;
+}
+
+void SharedFrameRing::close()
+{
+    if (m_header) UnmapViewOfFile(m_header);
+    if (m_mapping) CloseHandle(static_cast<HANDLE>(m_mapping));
+    m_header = nullptr;
+    m_mapping = nullptr;
+    m_mappedSize = 0;
+    m_slotCount = 0;
+    m_slotSize = 0;
+    m_owner = false;
+    m_name.clear();
+    m_readSeq = 0;
+}
+
+#else
+
+bool SharedFrameRing::mapRegion(const QString& name, quint64 size, bool create)
+{
+    const QByteArray path = posixName(name);
+    const int fd = create ? shm_open(path.constData(), O_CREAT | O_EXCL | O_RDWR, 0600)
+                          : shm_open(path.constData(), O_RDWR, 0);
+    if (fd < 0) return false;
+
+    if (create) {
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            shm_unlink(path.constData());
+            return false;
+        }
+    } else {
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<quint64>(st.st_size) < size) {
+            ::close(fd);
+            return false;
+        }
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        ::close(fd);
+        if (create) shm_unlink(path.constData());
+        return false;
+    }
+
+    m_fd = fd;
+    m_header = static_cast<RingHeader*>(view);
+    m_mappedSize = size;
+    return true;
+}
+
+void SharedFrameRing::close()
+{
+    if (m_header) munmap(static_cast<void*>(m_header), static_cast<size_t>(m_mappedSize));
+    if (m_fd >= 0) ::close(m_fd);
+    // O criador remove o nome; quem já mapeou continua válido até munmap
+    if (m_owner && !m_name.isEmpty()) shm_unlink(posixName(m_name).constData());
+    m_header = nullptr;
+    m_fd = -1;
+    m_mappedSize = 0;
+    m_slotCount = 0;
+    m_slotSize = 0;
+    m_owner = false;
+    m_name.clear();
+    m_readSeq = 0;
+}
+
+#endif
+
+} // namespace DriverProtocol
@@ -0,0 +1,135 @@
+#ifndef SHARED_FRAME_RING_H
+#define SHARED_FRAME_RING_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+
+#include <atomic>
+
+#include "DriverFramer.h"
+
+namespace DriverProtocol {
+
+// Anel de slots de frame em memória compartilhada (transporte opcional).
+//
+// O plugin cria o anel e publica os frames de LED nele; o socket passa a
+// carregar apenas mensagens de controle e FrameDoorbell (número de
+// sequência do último frame publicado). O driver abre o mesmo anel e, ao
+// receber o doorbell, lê os slots até aquela sequência.
+//
+// Cada slot é protegido por um seqlock: o escritor marca a sequência como
+// ímpar durante a escrita e publica 2*seq ao final. Leitores que encontram
+// um slot sobrescrito (anel deu a volta) descartam o frame e o contam em
+// droppedFrames(); o próximo frame íntegro é sempre entregue. Como deltas
+// também passam pelo anel, quem drena precisa tratar qualquer perda como
+// referência inválida (o driver pede um keyframe).
+//
+// A geometria (slotCount/slotSize) é validada uma vez em open() e guardada
+// no objeto: o cabeçalho continua gravável pelo outro processo, e um valor
+// trocado depois não pode levar o leitor para fora do seu mapeamento.
+//
+// Windows: CreateFileMapping/MapViewOfFile. Linux/POSIX: shm_open/mmap.
+// Nos dois, create() falha se o nome já existe.
+class SharedFrameRing {
+public:
+    static constexpr quint32 Magic   = 0x524C4457; // "WDLR"
+    static constexpr quint32 Version = 1;
+
+    SharedFrameRing() = default;
+    ~SharedFrameRing();
+
+    SharedFrameRing(const SharedFrameRing&) = delete;
+    SharedFrameRing& operator=(const SharedFrameRing&) = delete;
+
+    // Lado escritor (plugin): cria e inicializa a região.
+    bool create(const QString& name, quint32 slotCount, quint32 slotSize);
+    // Lado leitor (driver): abre região existente e lê a geometria do cabeçalho.
+    bool open(const QString& name);
+    void close();
+
+    bool isValid() const { return m_header != nullptr; }
+    QString name() const { return m_name; }
+    quint32 slotCount() const { return m_slotCount; }
+    quint32 slotSize() const { return m_slotSize; }
+
+    // Publica um frame; retorna a sequência (>= 1) ou 0 se não couber.
+    quint64 publish(quint16 type, const char* data, int size);
+
+    // Copia o frame 'seq' para 'scratch' (reutilizado). Retorna false se o
+    // slot já foi sobrescrito ou estava em escrita.
+    bool read(quint64 seq, quint16& outType, QByteArray& scratch) const;
+
+    // Entrega todos os frames publicados até 'upToSeq' que ainda não foram
+    // lidos. Handler: void(MessageType type, const PayloadView& payload)
+    template <typename Handler>
+    int drain(quint64 upToSeq, QByteArray& scratch, Handler&& handler)
+    {
+        if (!isValid() || upToSeq <= m_readSeq) return 0;
+
+        // Anel deu a volta: frames mais antigos que slotCount já se perderam
+        const quint64 capacity = slotCount();
+        if (upToSeq - m_readSeq > capacity) {
+            m_dropped += (upToSeq - m_readSeq) - capacity;
+            m_readSeq = upToSeq - capacity;
+        }
+
+        int delivered = 0;
+        for (quint64 seq = m_readSeq + 1; seq <= upToSeq; ++seq) {
+            quint16 type = 0;
+            if (!read(seq, type, scratch)) {
+                ++m_dropped;
+                continue;
+            }
+            PayloadView view;
+            view.data = scratch.constData();
+            view.size = scratch.size();
+            handler(static_cast<MessageType>(type), view);
+            ++delivered;
+        }
+        m_readSeq = upToSeq;
+        return delivered;
+    }
+
+    quint64 droppedFrames() const { return m_dropped; }
+
+private:
+    struct RingHeader {
+        quint32 magic;
+        quint32 version;
+        quint32 slotCount;
+        quint32 slotSize;
+        std::atomic<quint64> writeSeq; // último frame publicado
+    };
+
+    struct SlotHeader {
+        std::atomic<quint64> seq; // 2*frameSeq publicado; ímpar = escrita em andamento
+        quint16 type;
+        quint16 reserved;
+        quint32 size;
+    };
+
+    static quint64 regionSize(quint32 slotCount, quint32 slotSize);
+    SlotHeader* slotAt(quint64 seq) const;
+    bool mapRegion(const QString& name, quint64 size, bool create);
+
+    QString m_name;
+    RingHeader* m_header = nullptr;
+    quint64 m_mappedSize = 0;
+    quint32 m_slotCount = 0; // geometria validada; nunca relida do cabeçalho
+    quint32 m_slotSize = 0;
+    bool m_owner = false;
+
+    quint64 m_readSeq = 0; // leitor: última sequência processada
+    quint64 m_dropped = 0;
+
+#ifdef Q_OS_WIN
+    void* m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
+
+} // namespace DriverProtocol
+
+#endif // SHARED_FRAME_RING_H
@@ -0,0 +1,124 @@
+#include "CaptureWriter.h"
+#include "DriverMetrics.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QMutexLocker>
+
+using namespace DriverProtocol;
+
+CaptureWriter::CaptureWriter(const QString& path)
+    : m_file(path)
+{
+    // Capacidade reservada nos dois buffers: a troca a cada flush não aloca
+    m_pending.reserve(FlushThreshold + 64 * 1024);
+    m_writing.reserve(FlushThreshold + 64 * 1024);
+}
+
+CaptureWriter::~CaptureWriter()
+{
+    close();
+}
+
+bool CaptureWriter::open()
+{
+    if (m_writer) return true;
+
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "CaptureWriter: cannot open" << m_file.fileName() << ":" << m_file.errorString();
+        return false;
+    }
+
+    const qint64 startNs = DriverMetrics::monotonicNs();
+    char header[CaptureFileHeaderSize];
+    writeCaptureFileHeader(header, static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()), startNs);
+    m_file.write(header, CaptureFileHeaderSize);
+
+    {
+        QMutexLocker lock(&m_mutex);
+        m_startNs = startNs;
+        m_stopping = false;
+        m_pending.resize(0);
+    }
+    m_records.store(0, std::memory_order_relaxed);
+    m_dropped.store(0, std::memory_order_relaxed);
+
+    m_writer.reset(QThread::create([this]() { writeLoop(); }));
+    m_writer->setObjectName("WDL Capture");
+    m_writer->start(QThread::LowPriority);
+    m_active.store(true, std::memory_order_release);
+    return true;
+}
+
+void CaptureWriter::close()
+{
+    if (!m_writer) return;
+
+    m_active.store(false, std::memory_order_release);
+    {
+        QMutexLocker lock(&m_mutex);
+        m_stopping = true;
+        m_flushDue.wakeOne();
+    }
+    // A thread grava o que restou antes de sair
+    m_writer->wait();
+    m_writer.reset();
+
+    m_file.close();
+    qInfo() << "Capture" << m_file.fileName() << "closed with" << recordCount() << "records,"
+            << droppedRecords() << "dropped";
+}
+
+void CaptureWriter::record(quint64 clientId, MessageType type, const PayloadView& payload)
+{
+    if (!m_active.load(std::memory_order_acquire)) return;
+
+    QMutexLocker lock(&m_mutex);
+    if (m_stopping) return;
+
+    // Escrita parada no disco: descarta em vez de crescer sem limite
+    const int at = m_pending.size();
+    const qint64 recordSize = qint64(CaptureRecordHeaderSize) + HeaderSize + payload.size;
+    if (at + recordSize > MaxPendingBytes) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const qint64 now = DriverMetrics::monotonicNs();
+    m_pending.resize(at + static_cast<int>(recordSize));
+    char* p = m_pending.data() + at;
+    writeCaptureRecordHeader(p, static_cast<quint64>(now - m_startNs), static_cast<quint32>(clientId));
+    writeHeader(p + CaptureRecordHeaderSize, type, payload.size);
+    if (payload.size > 0) {
+        memcpy(p + CaptureRecordHeaderSize + HeaderSize, payload.data, static_cast<size_t>(payload.size));
+    }
+    m_records.fetch_add(1, std::memory_order_relaxed);
+
+    // Só acorda a escrita ao cruzar o limite (uma vez por lote)
+    if (at < FlushThreshold && m_pending.size() >= FlushThreshold) {
+        m_flushDue.wakeOne();
+    }
+}
+
+void CaptureWriter::writeLoop()
+{
+    bool stopping = false;
+    while (!stopping) {
+        {
+            QMutexLocker lock(&m_mutex);
+            if (!m_stopping && m_pending.size() < FlushThreshold) {
+                m_flushDue.wait(&m_mutex, FlushIntervalMs);
+            }
+            stopping = m_stopping;
+            m_pending.swap(m_writing);
+        }
+
+        // Disco fora do mutex: os workers seguem gravando no outro buffer
+        if (m_writing.isEmpty()) continue;
+        if (m_file.write(m_writing) != m_writing.size()) {
+            qWarning() << "CaptureWriter: short write to" << m_file.fileName() << ":" << m_file.errorString();
+        }
+        m_file.flush();
+        m_writing.resize(0);
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef CAPTURE_WRITER_H
+#define CAPTURE_WRITER_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QScopedPointer>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <atomic>
+
+#include "../common/CaptureFormat.h"
+
+// Grava as mensagens recebidas pelo driver no formato de CaptureFormat.h.
+//
+// record() pode ser chamado por qualquer worker: o registro é montado em um
+// buffer sob mutex, com o timestamp tirado dentro da seção crítica, o que
+// mantém o arquivo em ordem temporal. Nenhum worker toca no disco: uma
+// thread de escrita troca o buffer por um vazio sob o mutex e grava fora
+// dele, ao passar de FlushThreshold (acordada pelo record) ou a cada
+// FlushIntervalMs, mesmo sem mensagens novas. Com o disco atrasado o buffer
+// pendente para em MaxPendingBytes: registros além disso são descartados e
+// contados em droppedRecords().
+class CaptureWriter
+{
+public:
+    explicit CaptureWriter(const QString& path);
+    ~CaptureWriter();
+
+    bool open();
+    void close();
+
+    bool isOpen() const { return m_active.load(std::memory_order_relaxed); }
+    QString path() const { return m_file.fileName(); }
+    quint64 recordCount() const { return m_records.load(std::memory_order_relaxed); }
+    quint64 droppedRecords() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    void record(quint64 clientId, DriverProtocol::MessageType type, const DriverProtocol::PayloadView& payload);
+
+private:
+    static constexpr int FlushThreshold = 256 * 1024;
+    static constexpr int FlushIntervalMs = 1000;
+    static constexpr qint64 MaxPendingBytes = 64 * 1024 * 1024;
+
+    QFile m_file;            // só a thread de escrita, entre open() e close()
+    QMutex m_mutex;          // protege m_pending, m_stopping e m_startNs
+    QWaitCondition m_flushDue;
+    QByteArray m_pending;    // registros ainda não entregues à escrita
+    QByteArray m_writing;    // lote em gravação (fora do mutex)
+    QScopedPointer<QThread> m_writer;
+    bool m_stopping = false;
+    qint64 m_startNs = 0;
+    std::atomic<bool> m_active { false };
+    std::atomic<quint64> m_records { 0 };
+    std::atomic<quint64> m_dropped { 0 };
+
+    void writeLoop();
+};
+
+#endif // CAPTURE_WRITER_H
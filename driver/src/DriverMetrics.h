@@ -0,0 +1,257 @@
+#ifndef DRIVER_METRICS_H
+#define DRIVER_METRICS_H
+
+#include <QtGlobal>
+#include <QtAlgorithms>
+#include <QByteArray>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
+#include <QList>
+
+#include <atomic>
+
+#include "../common/DriverStats.h"
+#include "../common/FrameTiming.h"
+
+// Métricas do driver: contadores atômicos (relaxed) escritos no caminho
+// quente pelos workers e pelo consumidor e lidos sob demanda pelo
+// GetStatus/GetStats. Nada aqui aloca ou trava por frame.
+namespace DriverMetrics {
+
+// Relógio monotônico comum a todas as threads do driver. É o relógio de
+// apresentação do protocolo, então receivedNs e os timestamps de
+// TimedFrame são comparáveis diretamente.
+inline qint64 monotonicNs()
+{
+    return DriverProtocol::presentationClockNs();
+}
+
+// Histograma de buckets log2 fixos: o bucket b contém valores em
+// [2^(b-1), 2^b), com o bucket 0 reservado para zero.
+class Histogram {
+public:
+    static constexpr int BucketCount = 40; // até ~9 minutos em ns
+
+    void record(quint64 value)
+    {
+        m_buckets[bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static int bucketFor(quint64 value)
+    {
+        const int b = value == 0 ? 0 : 64 - static_cast<int>(qCountLeadingZeroBits(value));
+        return qMin(b, BucketCount - 1);
+    }
+
+    // Limite superior do bucket
+    static quint64 bucketLimit(int b)
+    {
+        return b == 0 ? 0 : (quint64(1) << b) - 1;
+    }
+
+    quint64 count() const
+    {
+        quint64 n = 0;
+        for (const auto& b : m_buckets) n += b.load(std::memory_order_relaxed);
+        return n;
+    }
+
+    // p em [0, 1]; aproximado pelo limite superior do bucket
+    quint64 percentile(double p) const
+    {
+        quint64 counts[BucketCount];
+        quint64 total = 0;
+        for (int b = 0; b < BucketCount; ++b) {
+            counts[b] = m_buckets[b].load(std::memory_order_relaxed);
+            total += counts[b];
+        }
+        if (total == 0) return 0;
+
+        const quint64 rank = qMax<quint64>(1, static_cast<quint64>(p * static_cast<double>(total) + 0.5));
+        quint64 seen = 0;
+        for (int b = 0; b < BucketCount; ++b) {
+            seen += counts[b];
+            if (seen >= rank) return bucketLimit(b);
+        }
+        return bucketLimit(BucketCount - 1);
+    }
+
+    // {"count":N,"p50":..,"p99":..,"buckets":[..]} (zeros finais omitidos)
+    QByteArray toJson() const
+    {
+        int last = -1;
+        for (int b = 0; b < BucketCount; ++b) {
+            if (m_buckets[b].load(std::memory_order_relaxed) != 0) last = b;
+        }
+        QByteArray buckets;
+        for (int b = 0; b <= last; ++b) {
+            if (b > 0) buckets += ',';
+            buckets += QByteArray::number(m_buckets[b].load(std::memory_order_relaxed));
+        }
+        return "{\"count\":" + QByteArray::number(count())
+             + ",\"p50\":" + QByteArray::number(percentile(0.50))
+             + ",\"p99\":" + QByteArray::number(percentile(0.99))
+             + ",\"buckets\":[" + buckets + "]}";
+    }
+
+private:
+    std::atomic<quint64> m_buckets[BucketCount] {};
+};
+
+// Taxa por segundo em janelas de ~1 s. add() pode ser chamado de qualquer
+// thread; tick() apenas pela thread dona, que fecha as janelas. Sem
+// atividade a janela não fecha e perSecond() passa a decair pela média
+// desde o início da janela aberta.
+class RateMeter {
+public:
+    static constexpr qint64 WindowNs = 1000000000;
+
+    void add(quint64 n) { m_total.fetch_add(n, std::memory_order_relaxed); }
+    quint64 total() const { return m_total.load(std::memory_order_relaxed); }
+
+    void tick(qint64 nowNs)
+    {
+        const qint64 start = m_windowStartNs.load(std::memory_order_relaxed);
+        const quint64 total = m_total.load(std::memory_order_relaxed);
+        if (start == 0) {
+            m_windowStartTotal.store(total, std::memory_order_relaxed);
+            m_windowStartNs.store(nowNs, std::memory_order_relaxed);
+            return;
+        }
+        const qint64 elapsed = nowNs - start;
+        if (elapsed < WindowNs) return;
+
+        const quint64 delta = total - m_windowStartTotal.load(std::memory_order_relaxed);
+        m_lastRate.store(static_cast<quint64>(static_cast<double>(delta) * 1e9 / static_cast<double>(elapsed)),
+                         std::memory_order_relaxed);
+        m_windowStartTotal.store(total, std::memory_order_relaxed);
+        m_windowStartNs.store(nowNs, std::memory_order_relaxed);
+    }
+
+    quint64 perSecond(qint64 nowNs) const
+    {
+        const qint64 start = m_windowStartNs.load(std::memory_order_relaxed);
+        if (start == 0) return 0;
+        const qint64 elapsed = nowNs - start;
+        if (elapsed <= 2 * WindowNs) return m_lastRate.load(std::memory_order_relaxed);
+        const quint64 delta = total() - m_windowStartTotal.load(std::memory_order_relaxed);
+        return static_cast<quint64>(static_cast<double>(delta) * 1e9 / static_cast<double>(elapsed));
+    }
+
+private:
+    std::atomic<quint64> m_total { 0 };
+    std::atomic<qint64> m_windowStartNs { 0 };
+    std::atomic<quint64> m_windowStartTotal { 0 };
+    std::atomic<quint64> m_lastRate { 0 };
+};
+
+// Máximo atômico (vários escritores possíveis)
+inline void updateMax(std::atomic<quint32>& target, quint32 value)
+{
+    quint32 current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+// Métricas de uma conexão. Criadas pelo worker dono do socket e
+// compartilhadas com o consumidor (via ConsumerItem) e com o registro.
+struct ClientMetrics {
+    quint64 clientId = 0;
+    int worker = -1;
+
+    RateMeter frames; // mensagens de frame recebidas
+    RateMeter bytes;
+    std::atomic<quint64> messages { 0 };
+    std::atomic<quint64> framesApplied { 0 };
+    std::atomic<quint64> framesSuperseded { 0 };
+    std::atomic<quint64> framesDropped { 0 };
+    std::atomic<quint32> framesLate { 0 };
+    std::atomic<quint32> deltasRejected { 0 };
+    std::atomic<quint32> timedFramesMalformed { 0 }; // só no JSON (fora do layout fixo do DriverStats)
+    std::atomic<quint32> maxBacklogBytes { 0 };
+    std::atomic<quint32> maxQueueDepth { 0 };
+
+    Histogram parseNs;     // por mensagem, no worker
+    Histogram frameBytes;  // tamanho do payload de frame
+    Histogram latencyNs;   // recepção no worker -> aplicação no consumidor (inclui a espera pelo tick)
+
+    DriverProtocol::DriverStats snapshot(qint64 nowNs) const
+    {
+        DriverProtocol::DriverStats s;
+        s.framesIn         = frames.total();
+        s.bytesIn          = bytes.total();
+        s.framesApplied    = framesApplied.load(std::memory_order_relaxed);
+        s.framesSuperseded = framesSuperseded.load(std::memory_order_relaxed);
+        s.framesDropped    = framesDropped.load(std::memory_order_relaxed);
+        s.deltasRejected   = deltasRejected.load(std::memory_order_relaxed);
+        s.framesPerSec     = clamp32(frames.perSecond(nowNs));
+        s.bytesPerSec      = clamp32(bytes.perSecond(nowNs));
+        s.parseP50Ns       = clamp32(parseNs.percentile(0.50));
+        s.parseP99Ns       = clamp32(parseNs.percentile(0.99));
+        s.latencyP50Ns     = clamp32(latencyNs.percentile(0.50));
+        s.latencyP99Ns     = clamp32(latencyNs.percentile(0.99));
+        s.maxBacklogBytes  = maxBacklogBytes.load(std::memory_order_relaxed);
+        s.maxQueueDepth    = maxQueueDepth.load(std::memory_order_relaxed);
+        s.framesLate       = framesLate.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    QByteArray toJson(qint64 nowNs) const
+    {
+        const DriverProtocol::DriverStats s = snapshot(nowNs);
+        return "{\"id\":" + QByteArray::number(clientId)
+             + ",\"worker\":" + QByteArray::number(worker)
+             + ",\"messages\":" + QByteArray::number(messages.load(std::memory_order_relaxed))
+             + ",\"framesIn\":" + QByteArray::number(s.framesIn)
+             + ",\"bytesIn\":" + QByteArray::number(s.bytesIn)
+             + ",\"framesPerSec\":" + QByteArray::number(s.framesPerSec)
+             + ",\"bytesPerSec\":" + QByteArray::number(s.bytesPerSec)
+             + ",\"framesApplied\":" + QByteArray::number(s.framesApplied)
+             + ",\"framesSuperseded\":" + QByteArray::number(s.framesSuperseded)
+             + ",\"framesDropped\":" + QByteArray::number(s.framesDropped)
+             + ",\"framesLate\":" + QByteArray::number(s.framesLate)
+             + ",\"deltasRejected\":" + QByteArray::number(s.deltasRejected)
+             + ",\"timedFramesMalformed\":" + QByteArray::number(timedFramesMalformed.load(std::memory_order_relaxed))
+             + ",\"maxBacklogBytes\":" + QByteArray::number(s.maxBacklogBytes)
+             + ",\"maxQueueDepth\":" + QByteArray::number(s.maxQueueDepth)
+             + ",\"parseNs\":" + parseNs.toJson()
+             + ",\"frameBytes\":" + frameBytes.toJson()
+             + ",\"latencyNs\":" + latencyNs.toJson() + "}";
+    }
+
+private:
+    static quint32 clamp32(quint64 v) { return v > 0xFFFFFFFFull ? 0xFFFFFFFFu : static_cast<quint32>(v); }
+};
+
+// Conexões ativas, para o StatusResponse listar todos os clientes. Só é
+// tocado na conexão/desconexão e nas consultas de status.
+class MetricsRegistry {
+public:
+    void add(const QSharedPointer<ClientMetrics>& metrics)
+    {
+        QMutexLocker lock(&m_mutex);
+        m_clients.insert(metrics->clientId, metrics);
+    }
+
+    void remove(quint64 clientId)
+    {
+        QMutexLocker lock(&m_mutex);
+        m_clients.remove(clientId);
+    }
+
+    QList<QSharedPointer<ClientMetrics>> clients() const
+    {
+        QMutexLocker lock(&m_mutex);
+        return m_clients.values();
+    }
+
+private:
+    mutable QMutex m_mutex;
+    QMap<quint64, QSharedPointer<ClientMetrics>> m_clients;
+};
+
+} // namespace DriverMetrics
+
+#endif // DRIVER_METRICS_H
@@ -0,0 +1,138 @@
+#include "FramePacer.h"
+#include "WDLFrameConsumer.h"
+
+QByteArray PresentationStats::toJson() const
+{
+    return "{\"ticks\":" + QByteArray::number(ticks.load(std::memory_order_relaxed))
+         + ",\"ticksMissed\":" + QByteArray::number(ticksMissed.load(std::memory_order_relaxed))
+         + ",\"framesPresented\":" + QByteArray::number(framesPresented.load(std::memory_order_relaxed))
+         + ",\"framesLate\":" + QByteArray::number(framesLate.load(std::memory_order_relaxed))
+         + ",\"framesSkipped\":" + QByteArray::number(framesSkipped.load(std::memory_order_relaxed))
+         + ",\"framesOverflow\":" + QByteArray::number(framesOverflow.load(std::memory_order_relaxed))
+         + ",\"maxQueuedFrames\":" + QByteArray::number(maxQueuedFrames.load(std::memory_order_relaxed))
+         + ",\"tickJitterNs\":" + tickJitterNs.toJson()
+         + ",\"presentErrorNs\":" + presentErrorNs.toJson() + "}";
+}
+
+bool FramePacer::enqueue(ConsumerItem& item, qint64 nowNs)
+{
+    const bool timed = item.presentAtNs != 0;
+    qint64 presentAt = timed ? item.presentAtNs : item.receivedNs;
+    if (timed && presentAt < nowNs - m_lateToleranceNs) {
+        m_stats.framesLate.fetch_add(1, std::memory_order_relaxed);
+        if (item.metrics) item.metrics->framesLate.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // Relógio do cliente fora do domínio esperado não pode travar a fila
+    presentAt = qMin(presentAt, nowNs + MaxLeadNs);
+
+    QVector<PendingFrame>& timeline = m_timelines[item.clientId];
+    if (timeline.size() >= MaxQueuedFrames) {
+        m_stats.framesOverflow.fetch_add(1, std::memory_order_relaxed);
+        if (timeline.first().metrics) timeline.first().metrics->framesDropped.fetch_add(1, std::memory_order_relaxed);
+        // O brilho do frame descartado passa ao seguinte (um mais novo prevalece)
+        if (timeline.first().hasBrightness && timeline.size() > 1 && !timeline.at(1).hasBrightness) {
+            timeline[1].hasBrightness = true;
+            timeline[1].brightness = timeline.first().brightness;
+        }
+        recycle(timeline.first());
+        timeline.removeFirst();
+    }
+
+    // Horários normalmente crescentes: o frame vai para o fim
+    int at = timeline.size();
+    while (at > 0 && timeline.at(at - 1).presentAtNs > presentAt) --at;
+    timeline.insert(at, PendingFrame());
+
+    PendingFrame& frame = timeline[at];
+    frame.presentAtNs = presentAt;
+    frame.receivedNs = item.receivedNs;
+    frame.timed = timed;
+    if (!m_spareColors.isEmpty()) frame.colors = m_spareColors.takeLast();
+    frame.colors.swap(item.colors);
+    frame.layout = item.layout; // compartilhado implicitamente
+    frame.metrics = item.metrics;
+
+    DriverMetrics::updateMax(m_stats.maxQueuedFrames, static_cast<quint32>(timeline.size()));
+    return true;
+}
+
+qint64 FramePacer::nextDueNs() const
+{
+    // Linhas do tempo ordenadas por presentAtNs: basta o primeiro de cada
+    qint64 due = NoneDue;
+    for (const QVector<PendingFrame>& timeline : m_timelines) {
+        if (!timeline.isEmpty()) due = qMin(due, timeline.first().presentAtNs);
+    }
+    return due;
+}
+
+void FramePacer::present(qint64 tickNs, qint64 nowNs, LampArrayStore& lamps)
+{
+    m_stats.ticks.fetch_add(1, std::memory_order_relaxed);
+    m_stats.tickJitterNs.record(static_cast<quint64>(qMax<qint64>(0, nowNs - tickNs)));
+
+    for (auto it = m_timelines.begin(); it != m_timelines.end(); ++it) {
+        QVector<PendingFrame>& timeline = it.value();
+        int due = 0;
+        while (due < timeline.size() && timeline.at(due).presentAtNs <= tickNs) ++due;
+        if (due == 0) continue;
+
+        // Só o mais novo dos vencidos é exibido
+        const PendingFrame& frame = timeline.at(due - 1);
+        lamps.applyFrame(it.key(), frame.colors, frame.layout);
+        m_stats.framesPresented.fetch_add(1, std::memory_order_relaxed);
+        if (frame.timed) {
+            m_stats.presentErrorNs.record(static_cast<quint64>(qMax<qint64>(0, nowNs - frame.presentAtNs)));
+        }
+        if (frame.metrics) {
+            frame.metrics->framesApplied.fetch_add(1, std::memory_order_relaxed);
+            frame.metrics->latencyNs.record(static_cast<quint64>(nowNs - frame.receivedNs));
+        }
+
+        // Brilho mais novo entre os vencidos, depois do frame que o precede
+        for (int i = due - 1; i >= 0; --i) {
+            if (timeline.at(i).hasBrightness) {
+                lamps.setBrightness(it.key(), timeline.at(i).brightness);
+                break;
+            }
+        }
+
+        if (due > 1) {
+            m_stats.framesSkipped.fetch_add(static_cast<quint64>(due - 1), std::memory_order_relaxed);
+            if (frame.metrics) {
+                frame.metrics->framesSuperseded.fetch_add(static_cast<quint64>(due - 1), std::memory_order_relaxed);
+            }
+        }
+
+        for (int i = 0; i < due; ++i) recycle(timeline[i]);
+        timeline.remove(0, due);
+    }
+}
+
+bool FramePacer::deferBrightness(quint64 clientId, float brightness)
+{
+    const auto it = m_timelines.find(clientId);
+    if (it == m_timelines.end() || it.value().isEmpty()) return false;
+    PendingFrame& last = it.value().last();
+    last.hasBrightness = true;
+    last.brightness = brightness;
+    return true;
+}
+
+void FramePacer::removeClient(quint64 clientId)
+{
+    const auto it = m_timelines.find(clientId);
+    if (it == m_timelines.end()) return;
+    for (PendingFrame& frame : it.value()) recycle(frame);
+    m_timelines.erase(it);
+}
+
+void FramePacer::recycle(PendingFrame& frame)
+{
+    // Mantém só o suficiente para repor uma fila cheia
+    if (m_spareColors.size() < MaxQueuedFrames) m_spareColors.append(std::move(frame.colors));
+    frame.layout.clear();
+    frame.metrics.reset();
+    frame.hasBrightness = false;
+}
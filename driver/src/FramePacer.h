@@ -0,0 +1,96 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QHash>
+#include <QSharedPointer>
+#include <QVector>
+
+#include <atomic>
+#include <limits>
+
+#include "DriverMetrics.h"
+#include "LampArrayStore.h"
+#include "../common/DeviceFrame.h"
+
+struct ConsumerItem;
+
+// Estatísticas de apresentação. Escritas só pela thread consumidora e
+// lidas por qualquer thread (GetStatus).
+struct PresentationStats {
+    std::atomic<quint64> ticks { 0 };
+    std::atomic<quint64> ticksMissed { 0 };     // períodos inteiros perdidos com o consumidor atrasado
+    std::atomic<quint64> framesPresented { 0 };
+    std::atomic<quint64> framesLate { 0 };      // chegaram depois do seu instante: descartados
+    std::atomic<quint64> framesSkipped { 0 };   // vencidos no mesmo tick que um frame mais novo
+    std::atomic<quint64> framesOverflow { 0 };  // fila de futuros cheia: o mais antigo sai
+    std::atomic<quint32> maxQueuedFrames { 0 }; // maior fila de futuros de um cliente
+
+    DriverMetrics::Histogram tickJitterNs;    // início real do tick - instante agendado
+    DriverMetrics::Histogram presentErrorNs;  // apresentação - presentAtNs pedido (só TimedFrame)
+
+    QByteArray toJson() const;
+};
+
+// Linha do tempo de apresentação do consumidor. Cada cliente tem uma fila
+// curta de frames ordenada por presentAtNs; a cada tick do agendador o
+// frame mais novo já vencido de cada cliente vai para o LampArrayStore e
+// os vencidos mais antigos são pulados. Frames sem horário entram com o
+// instante da chegada e saem no tick seguinte.
+//
+// Usado apenas pela thread consumidora.
+class FramePacer
+{
+public:
+    static constexpr int MaxQueuedFrames = 8;        // por cliente
+    static constexpr qint64 MaxLeadNs = 1000000000;  // horários além disso são limitados
+    static constexpr qint64 NoneDue = std::numeric_limits<qint64>::max();
+
+    // Tolerância de atraso na chegada (tipicamente um período de refresh)
+    void setLateToleranceNs(qint64 ns) { m_lateToleranceNs = ns; }
+
+    // Move o frame do item para a fila do cliente. Os buffers são trocados
+    // com um frame já apresentado, então o slot volta à fila SPSC com
+    // capacidade. Retorna false se o frame chegou atrasado e foi descartado.
+    bool enqueue(ConsumerItem& item, qint64 nowNs);
+
+    // Menor presentAtNs entre os frames na fila, ou NoneDue sem frames: o
+    // agendador só acorda (e só gira) para ticks com algo a apresentar
+    qint64 nextDueNs() const;
+
+    // Apresenta os frames vencidos até tickNs (nowNs = início real do tick)
+    void present(qint64 tickNs, qint64 nowNs, LampArrayStore& lamps);
+
+    // Brilho na ordem dos frames: com frames do cliente ainda na fila, a
+    // mudança vale a partir da apresentação do último deles (os frames
+    // enviados antes dela não aparecem com o brilho novo). Retorna false
+    // sem frames pendentes: o chamador aplica na hora.
+    bool deferBrightness(quint64 clientId, float brightness);
+
+    void removeClient(quint64 clientId);
+
+    PresentationStats& stats() { return m_stats; }
+    const PresentationStats& stats() const { return m_stats; }
+
+private:
+    struct PendingFrame {
+        qint64 presentAtNs = 0;
+        qint64 receivedNs = 0;
+        bool timed = false;
+        bool hasBrightness = false; // SetBrightness recebido depois deste frame
+        float brightness = 1.0f;
+        QByteArray colors;
+        QVector<DriverProtocol::DeviceFrameEntry> layout;
+        QSharedPointer<DriverMetrics::ClientMetrics> metrics;
+    };
+
+    QHash<quint64, QVector<PendingFrame>> m_timelines;
+    QVector<QByteArray> m_spareColors; // buffers de frames já apresentados
+    qint64 m_lateToleranceNs = 0;
+    PresentationStats m_stats;
+
+    void recycle(PendingFrame& frame);
+};
+
+#endif // FRAME_PACER_H
@@ -0,0 +1,216 @@
+#include "LampArrayStore.h"
+#include "LampKernels.h"
+
+#include <QMutexLocker>
+
+#include <atomic>
+#include <cstring>
+
+using namespace DriverProtocol;
+using namespace LampKernels;
+
+std::shared_ptr<LampBuffer> LampArray::takeSpare(int lampCount)
+{
+    std::shared_ptr<LampBuffer> next;
+    // Nenhum leitor segura mais a geração anterior: reaproveita os planos
+    if (m_spare && m_spare.use_count() == 1) {
+        next = std::move(m_spare);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } else {
+        next = std::make_shared<LampBuffer>();
+    }
+    m_spare.reset();
+
+    const int padded = paddedLampCount(lampCount);
+    next->red.resize(padded);
+    next->green.resize(padded);
+    next->blue.resize(padded);
+    next->outRed.resize(padded);
+    next->outGreen.resize(padded);
+    next->outBlue.resize(padded);
+    next->dirty.resize(padded / LampBlock);
+    next->lampCount = lampCount;
+    return next;
+}
+
+void LampArray::applyFrame(const Segment* segments, int segmentCount)
+{
+    int lamps = 0;
+    for (int i = 0; i < segmentCount; ++i) {
+        lamps += segments[i].count;
+    }
+
+    const std::shared_ptr<LampBuffer> next = takeSpare(lamps);
+    quint8* r = next->red.data();
+    quint8* g = next->green.data();
+    quint8* b = next->blue.data();
+
+    int at = 0;
+    for (int i = 0; i < segmentCount; ++i) {
+        deinterleaveRgb(segments[i].rgb, segments[i].count, r + at, g + at, b + at);
+        at += segments[i].count;
+    }
+
+    const size_t tail = static_cast<size_t>(next->red.size() - lamps);
+    if (tail > 0) {
+        memset(r + lamps, 0, tail);
+        memset(g + lamps, 0, tail);
+        memset(b + lamps, 0, tail);
+    }
+
+    finish(next, false);
+}
+
+void LampArray::setBrightness(quint8 level)
+{
+    if (level == m_brightness) return;
+    m_brightness = level;
+    if (!m_front) return; // aplicado no primeiro frame
+
+    const std::shared_ptr<LampBuffer> next = takeSpare(m_front->lampCount);
+    const size_t bytes = static_cast<size_t>(next->red.size());
+    if (bytes > 0) {
+        memcpy(next->red.data(), m_front->red.constData(), bytes);
+        memcpy(next->green.data(), m_front->green.constData(), bytes);
+        memcpy(next->blue.data(), m_front->blue.constData(), bytes);
+    }
+
+    finish(next, true);
+}
+
+void LampArray::finish(const std::shared_ptr<LampBuffer>& next, bool sameColors)
+{
+    const int padded = next->red.size();
+    next->brightness = m_brightness;
+    next->generation = m_front ? m_front->generation + 1 : 1;
+
+    quint64* dirty = next->dirty.data();
+    const int words = next->dirty.size();
+    const bool comparable = m_front && m_front->lampCount == next->lampCount
+                         && m_front->brightness == m_brightness && !sameColors;
+    if (comparable) {
+        if (words > 0) memset(dirty, 0, static_cast<size_t>(words) * sizeof(quint64));
+        diffMask(next->red.constData(), next->green.constData(), next->blue.constData(),
+                 m_front->red.constData(), m_front->green.constData(), m_front->blue.constData(),
+                 padded, dirty);
+    } else {
+        // Geometria ou brilho mudou: toda a saída é nova
+        for (int w = 0; w < words; ++w) dirty[w] = ~quint64(0);
+        const int rest = next->lampCount % LampBlock;
+        if (words > 0 && rest != 0) dirty[words - 1] = (quint64(1) << rest) - 1;
+    }
+
+    scale(next->red.constData(), padded, m_brightness, next->outRed.data());
+    scale(next->green.constData(), padded, m_brightness, next->outGreen.data());
+    scale(next->blue.constData(), padded, m_brightness, next->outBlue.data());
+
+    QMutexLocker lock(&m_mutex);
+    m_spare = std::move(m_front);
+    m_front = next;
+}
+
+LampSnapshot LampArray::snapshot() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_front;
+}
+
+LampArray* LampArrayStore::array(quint64 clientId, quint16 deviceId, quint8 brightness)
+{
+    const quint64 k = key(clientId, deviceId);
+    const auto it = m_arrays.constFind(k);
+    if (it != m_arrays.constEnd()) return it.value().data();
+
+    QSharedPointer<LampArray> created(new LampArray);
+    created->setBrightness(brightness);
+    QMutexLocker lock(&m_mutex);
+    m_arrays.insert(k, created);
+    return created.data();
+}
+
+void LampArrayStore::applyFrame(quint64 clientId, const QByteArray& colors, const QVector<DeviceFrameEntry>& layout)
+{
+    ClientDevices& client = m_clients[clientId];
+    const uchar* base = reinterpret_cast<const uchar*>(colors.constData());
+    const quint32 ledCount = static_cast<quint32>(colors.size() / 3);
+
+    m_frameDevices.resize(0);
+    if (layout.isEmpty()) {
+        m_segments.resize(0);
+        m_segments.append({ base, static_cast<int>(ledCount) });
+        array(clientId, 0, client.brightness)->applyFrame(m_segments.constData(), 1);
+        m_frameDevices.append(0);
+    } else {
+        // Zonas agrupadas por dispositivo, na ordem em que aparecem na tabela
+        for (int i = 0; i < layout.size(); ++i) {
+            const quint16 device = layout.at(i).deviceId;
+            if (m_frameDevices.contains(device)) continue;
+            m_frameDevices.append(device);
+
+            m_segments.resize(0);
+            for (int j = i; j < layout.size(); ++j) {
+                const DeviceFrameEntry& e = layout.at(j);
+                if (e.deviceId != device || e.offset > ledCount || e.count > ledCount - e.offset) continue;
+                m_segments.append({ base + static_cast<size_t>(e.offset) * 3, static_cast<int>(e.count) });
+            }
+            array(clientId, device, client.brightness)->applyFrame(m_segments.constData(), m_segments.size());
+        }
+    }
+
+    if (client.ids != m_frameDevices) retainDevices(clientId, client);
+}
+
+void LampArrayStore::retainDevices(quint64 clientId, ClientDevices& client)
+{
+    QMutexLocker lock(&m_mutex);
+    for (quint16 id : client.ids) {
+        if (!m_frameDevices.contains(id)) m_arrays.remove(key(clientId, id));
+    }
+    client.ids = m_frameDevices;
+}
+
+void LampArrayStore::setBrightness(quint64 clientId, float value)
+{
+    ClientDevices& client = m_clients[clientId];
+    client.brightness = static_cast<quint8>(qRound(qBound(0.0f, value, 1.0f) * 255.0f));
+    for (quint16 id : client.ids) {
+        array(clientId, id, client.brightness)->setBrightness(client.brightness);
+    }
+}
+
+void LampArrayStore::removeClient(quint64 clientId)
+{
+    const auto it = m_clients.constFind(clientId);
+    if (it == m_clients.constEnd()) return;
+
+    QMutexLocker lock(&m_mutex);
+    for (quint16 id : it.value().ids) {
+        m_arrays.remove(key(clientId, id));
+    }
+    m_clients.remove(clientId);
+}
+
+LampSnapshot LampArrayStore::snapshot(quint64 clientId, quint16 deviceId) const
+{
+    QMutexLocker lock(&m_mutex);
+    const auto it = m_arrays.constFind(key(clientId, deviceId));
+    return it != m_arrays.constEnd() ? it.value()->snapshot() : LampSnapshot();
+}
+
+QByteArray LampArrayStore::toJson() const
+{
+    QMutexLocker lock(&m_mutex);
+    QByteArray out("[");
+    for (auto it = m_arrays.constBegin(); it != m_arrays.constEnd(); ++it) {
+        const LampSnapshot s = it.value()->snapshot();
+        if (!s) continue;
+        if (out.size() > 1) out += ',';
+        out += "{\"client\":" + QByteArray::number(it.key() >> 16)
+             + ",\"device\":" + QByteArray::number(it.key() & 0xFFFF)
+             + ",\"lamps\":" + QByteArray::number(s->lampCount)
+             + ",\"brightness\":" + QByteArray::number(s->brightness)
+             + ",\"generation\":" + QByteArray::number(s->generation) + "}";
+    }
+    out += ']';
+    return out;
+}
@@ -0,0 +1,93 @@
+#ifndef LAMP_ARRAY_STORE_H
+#define LAMP_ARRAY_STORE_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QVector>
+
+#include <memory>
+
+#include "../common/DeviceFrame.h"
+
+// Estado de um LampArray virtual em planos por canal. Depois de publicado
+// um buffer nunca é alterado: leitores seguram o snapshot pelo tempo que
+// quiserem sem cópia e sem bloquear o escritor.
+struct LampBuffer {
+    quint64 generation = 0;
+    int lampCount = 0;
+    quint8 brightness = 255;
+
+    // Capacidade de paddedLampCount(lampCount), excedente zerado
+    QVector<quint8> red, green, blue;          // cor recebida
+    QVector<quint8> outRed, outGreen, outBlue; // cor * brilho (saída)
+
+    // Lamps cuja saída mudou em relação à geração anterior (64 por
+    // palavra). Um leitor que pulou gerações deve tratar tudo como sujo.
+    QVector<quint64> dirty;
+};
+
+using LampSnapshot = std::shared_ptr<const LampBuffer>;
+
+// Um dispositivo virtual. Escrito apenas pela thread consumidora; snapshot()
+// pode ser chamado de qualquer thread.
+class LampArray {
+public:
+    // Trecho RGB888 do frame; os trechos são concatenados na ordem das lamps
+    struct Segment {
+        const uchar* rgb;
+        int count;
+    };
+
+    void applyFrame(const Segment* segments, int segmentCount);
+    void setBrightness(quint8 level);
+
+    LampSnapshot snapshot() const;
+
+private:
+    std::shared_ptr<LampBuffer> m_front; // publicado (escrita só pelo consumidor)
+    std::shared_ptr<LampBuffer> m_spare; // geração anterior, reaproveitada quando liberada
+    quint8 m_brightness = 255;
+    mutable QMutex m_mutex;              // só protege a troca de m_front
+
+    std::shared_ptr<LampBuffer> takeSpare(int lampCount);
+    void finish(const std::shared_ptr<LampBuffer>& next, bool sameColors);
+};
+
+// LampArrays virtuais de todos os clientes, um por (cliente, deviceId).
+// Frames planos (sem tabela de dispositivos) viram o dispositivo 0.
+class LampArrayStore {
+public:
+    // Chamados pela thread consumidora
+    void applyFrame(quint64 clientId, const QByteArray& colors, const QVector<DriverProtocol::DeviceFrameEntry>& layout);
+    void setBrightness(quint64 clientId, float value);
+    void removeClient(quint64 clientId);
+
+    // Qualquer thread
+    LampSnapshot snapshot(quint64 clientId, quint16 deviceId) const;
+    QByteArray toJson() const;
+
+private:
+    struct ClientDevices {
+        QVector<quint16> ids; // dispositivos do último frame
+        quint8 brightness = 255;
+    };
+
+    static quint64 key(quint64 clientId, quint16 deviceId) { return (clientId << 16) | deviceId; }
+
+    mutable QMutex m_mutex; // protege inserções/remoções em m_arrays
+    QHash<quint64, QSharedPointer<LampArray>> m_arrays;
+    QHash<quint64, ClientDevices> m_clients;
+
+    // Scratch do consumidor, reutilizado entre frames
+    QVector<LampArray::Segment> m_segments;
+    QVector<quint16> m_frameDevices;
+
+    LampArray* array(quint64 clientId, quint16 deviceId, quint8 brightness);
+    void retainDevices(quint64 clientId, ClientDevices& client);
+};
+
+#endif // LAMP_ARRAY_STORE_H
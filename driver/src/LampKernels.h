@@ -0,0 +1,91 @@
+#ifndef LAMP_KERNELS_H
+#define LAMP_KERNELS_H
+
+#include <QtGlobal>
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WDL_LAMP_SSE2 1
+#endif
+
+// Kernels sobre planos de canal (structure-of-arrays) do LampArrayStore.
+// Os planos têm capacidade múltipla de LampBlock lamps com o excedente
+// zerado, então os laços vetoriais não precisam de tratamento de cauda.
+namespace LampKernels {
+
+constexpr int LampBlock = 64; // lamps por palavra de dirty bits
+
+inline int paddedLampCount(int lamps)
+{
+    return (lamps + LampBlock - 1) & ~(LampBlock - 1);
+}
+
+// RGB888 intercalado -> três planos. Laço simples, vetorizado pelo
+// compilador (ld3 no NEON, shuffles no x86).
+inline void deinterleaveRgb(const uchar* src, int n, quint8* r, quint8* g, quint8* b)
+{
+    for (int i = 0; i < n; ++i) {
+        r[i] = src[3 * i];
+        g[i] = src[3 * i + 1];
+        b[i] = src[3 * i + 2];
+    }
+}
+
+// Marca em 'dirty' (já zerado) as lamps com qualquer canal diferente do
+// estado anterior. n múltiplo de 16.
+inline void diffMask(const quint8* r, const quint8* g, const quint8* b,
+                     const quint8* pr, const quint8* pg, const quint8* pb,
+                     int n, quint64* dirty)
+{
+#ifdef WDL_LAMP_SSE2
+    for (int i = 0; i < n; i += 16) {
+        const __m128i er = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(r + i)),
+                                          _mm_loadu_si128(reinterpret_cast<const __m128i*>(pr + i)));
+        const __m128i eg = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(g + i)),
+                                          _mm_loadu_si128(reinterpret_cast<const __m128i*>(pg + i)));
+        const __m128i eb = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)),
+                                          _mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + i)));
+        const quint64 changed = ~static_cast<quint64>(_mm_movemask_epi8(_mm_and_si128(er, _mm_and_si128(eg, eb)))) & 0xFFFFu;
+        dirty[i / LampBlock] |= changed << (i % LampBlock);
+    }
+#else
+    for (int i = 0; i < n; ++i) {
+        const quint64 changed = ((r[i] ^ pr[i]) | (g[i] ^ pg[i]) | (b[i] ^ pb[i])) != 0;
+        dirty[i / LampBlock] |= changed << (i % LampBlock);
+    }
+#endif
+}
+
+// dst = src * level / 255, arredondado. n múltiplo de 16.
+inline void scale(const quint8* src, int n, quint8 level, quint8* dst)
+{
+    if (level == 255) {
+        memcpy(dst, src, static_cast<size_t>(n));
+        return;
+    }
+#ifdef WDL_LAMP_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lvl  = _mm_set1_epi16(level);
+    const __m128i bias = _mm_set1_epi16(128);
+    for (int i = 0; i < n; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(v, zero), lvl), bias);
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(v, zero), lvl), bias);
+        // x / 255 == (x + (x >> 8)) >> 8 para x <= 255*255 + 128
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+#else
+    for (int i = 0; i < n; ++i) {
+        const quint32 x = static_cast<quint32>(src[i]) * level + 128;
+        dst[i] = static_cast<quint8>((x + (x >> 8)) >> 8);
+    }
+#endif
+}
+
+} // namespace LampKernels
+
+#endif // LAMP_KERNELS_H
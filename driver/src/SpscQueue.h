@@ -0,0 +1,92 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <vector>
+
+// Fila lock-free de um produtor e um consumidor com slots pré-alocados.
+//
+// Os elementos são reutilizados no lugar: o produtor obtém o próximo slot
+// livre com beginPush(), preenche (reaproveitando buffers que o slot já
+// possui) e publica com commitPush(). O consumidor lê com front() e libera
+// com pop(). Nenhuma alocação no regime permanente.
+template <typename T>
+class SpscQueue {
+public:
+    // capacity é arredondada para potência de 2
+    explicit SpscQueue(quint32 capacity = 256)
+    {
+        quint32 cap = 2;
+        while (cap < capacity) cap <<= 1;
+        m_mask = cap - 1;
+        m_slots.resize(cap);
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Produtor: slot para escrita ou nullptr se a fila estiver cheia
+    T* beginPush()
+    {
+        const quint64 tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache > m_mask) {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache > m_mask) return nullptr;
+        }
+        return &m_slots[tail & m_mask];
+    }
+
+    void commitPush()
+    {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumidor: próximo elemento ou nullptr se vazia
+    T* front()
+    {
+        const quint64 head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tailCache) {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tailCache) return nullptr;
+        }
+        return &m_slots[head & m_mask];
+    }
+
+    // Elemento 'offset' posições após o primeiro (0 = front()), sem consumir
+    T* peek(quint32 offset)
+    {
+        const quint64 head = m_head.load(std::memory_order_relaxed);
+        if (head + offset >= m_tailCache) {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head + offset >= m_tailCache) return nullptr;
+        }
+        return &m_slots[(head + offset) & m_mask];
+    }
+
+    void pop()
+    {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Aproximado quando lido fora do consumidor/produtor
+    quint32 size() const
+    {
+        return static_cast<quint32>(m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire));
+    }
+
+    quint32 capacity() const { return m_mask + 1; }
+
+private:
+    std::vector<T> m_slots;
+    quint64 m_mask = 0;
+
+    // Índices em linhas de cache separadas para evitar false sharing
+    alignas(64) std::atomic<quint64> m_head { 0 }; // escrito pelo consumidor
+    quint64 m_tailCache = 0;                       // cache do consumidor
+    alignas(64) std::atomic<quint64> m_tail { 0 }; // escrito pelo produtor
+    quint64 m_headCache = 0;                       // cache do produtor
+};
+
+#endif // SPSC_QUEUE_H
@@ -1,139 +1,152 @@
 #include "WDLDriverServer.h"
 
 #include <QDebug>
-#include <QFile>
 
-using namespace DriverProtocol;
-
-WDLDriverServer::WDLDriverServer(const QString& serverName, QObject* parent)
+WDLDriverServer::WDLDriverServer(const QString& serverName, int workerCount, QObject* parent)
     : QObject(parent)
     , m_serverName(serverName)
 {
-    connect(&m_server, &QLocalServer::newConnection, this, &WDLDriverServer::onNewConnection);
+    if (workerCount <= 0) {
+        // Núcleos restantes ficam para o consumidor e o plugin
+        workerCount = qBound(1, QThread::idealThreadCount() / 2, 4);
+    }
+
+    m_consumer = new WDLFrameConsumer(workerCount);
+    for (int i = 0; i < workerCount; ++i) {
+        WDLIoWorker* worker = new WDLIoWorker(i, m_consumer, &m_metrics);
+        m_workers.append(worker);
+
+        connect(worker, &WDLIoWorker::clientConnected, this, [this](quint64 id) {
+            emit clientConnected(QString::number(id));
+        });
+        connect(worker, &WDLIoWorker::clientDisconnected, this, [this](quint64 id) {
+            emit clientDisconnected(QString::number(id));
+        });
+    }
+    for (WDLIoWorker* worker : m_workers) {
+        worker->setPeers(m_workers);
+    }
+
+    connect(&m_server, &WDLLocalServer::incomingDescriptor, this, &WDLDriverServer::onIncomingDescriptor);
 }
 
 WDLDriverServer::~WDLDriverServer()
 {
     stop();
+    qDeleteAll(m_workers);
+    delete m_consumer;
 }
 
 bool WDLDriverServer::start()
 {
+    if (m_capture && !m_capture->open()) {
+        return false;
+    }
+
     // Remover servidor antigo se existir (ex: crash anterior)
     QLocalServer::removeServer(m_serverName);
     if (!m_server.listen(m_serverName)) {
         qWarning() << "WDLDriverServer: failed to listen on" << m_serverName << ":" << m_server.errorString();
         return false;
     }
-    qInfo() << "WDLDriverServer listening on" << m_serverName;
+
+    m_consumer->start();
+    for (WDLIoWorker* worker : m_workers) {
+        QThread* thread = new QThread;
+        thread->setObjectName(QString("WDL I/O %1").arg(worker->index()));
+        worker->moveToThread(thread);
+        thread->start();
+        m_threads.append(thread);
+    }
+
+    qInfo() << "WDLDriverServer listening on" << m_serverName << "with" << m_workers.size() << "I/O workers"
+            << (m_consumer->coalescing() ? "(latest-frame-wins)" : "(in-order frames)");
+    if (m_consumer->refreshRate() > 0) {
+        qInfo() << "Paced output at" << m_consumer->refreshRate() << "Hz";
+    } else {
+        qInfo() << "Unpaced output (frames applied on arrival)";
+    }
+    if (m_capture) {
+        qInfo() << "Recording received messages to" << m_capture->path();
+    }
     return true;
 }
 
 void WDLDriverServer::stop()
 {
-    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
-        if (it.key()) {
-            it.key()->disconnect(this);
-            it.key()->close();
-        }
-    }
-    m_clients.clear();
-
     if (m_server.isListening()) {
         m_server.close();
     }
-    QLocalServer::removeServer(m_serverName);
-}
 
-void WDLDriverServer::onNewConnection()
-{
-    while (m_server.hasPendingConnections()) {
-        QLocalSocket* sock = m_server.nextPendingConnection();
-        if (!sock) continue;
-
-        ClientCtx ctx;
-        ctx.socket = sock;
-        m_clients.insert(sock, ctx);
-
-        connect(sock, &QLocalSocket::readyRead, this, &WDLDriverServer::onReadyRead);
-        connect(sock, &QLocalSocket::errorOccurred, this, &WDLDriverServer::onSocketError);
-        connect(sock, &QLocalSocket::disconnected, this, &WDLDriverServer::onDisconnected);
-
-        emit clientConnected(QString::number(reinterpret_cast<quintptr>(sock)));
-        qInfo() << "Client connected:" << sock;
+    // Sockets pertencem às threads dos workers: fechados lá antes do quit
+    for (int i = 0; i < m_threads.size(); ++i) {
+        WDLIoWorker* worker = m_workers[i];
+        QThread* home = thread();
+        QMetaObject::invokeMethod(worker, [worker, home]() {
+            worker->shutdown();
+            worker->moveToThread(home); // permite reiniciar e destruir na thread principal
+        }, Qt::BlockingQueuedConnection);
+        m_threads[i]->quit();
+        m_threads[i]->wait();
     }
-}
-
-void WDLDriverServer::onReadyRead()
-{
-    QLocalSocket* sock = qobject_cast<QLocalSocket*>(sender());
-    if (!sock || !m_clients.contains(sock)) return;
-
-    ClientCtx& ctx = m_clients[sock];
-    ctx.buffer.append(sock->readAll());
+    qDeleteAll(m_threads);
+    m_threads.clear();
 
-    processMessages(ctx);
+    m_consumer->stop();
+    if (m_capture) m_capture->close();
+    QLocalServer::removeServer(m_serverName);
 }
 
-void WDLDriverServer::onSocketError(QLocalSocket::LocalSocketError)
+void WDLDriverServer::setCoalescing(bool enabled)
 {
-    QLocalSocket* sock = qobject_cast<QLocalSocket*>(sender());
-    if (!sock) return;
-    qWarning() << "Socket error:" << sock->errorString();
+    m_consumer->setCoalescing(enabled);
+    for (WDLIoWorker* worker : m_workers) {
+        worker->setCoalescing(enabled);
+    }
 }
 
-void WDLDriverServer::onDisconnected()
+void WDLDriverServer::setRefreshRate(int hz)
 {
-    QLocalSocket* sock = qobject_cast<QLocalSocket*>(sender());
-    if (!sock) return;
-
-    m_clients.remove(sock);
-    emit clientDisconnected(QString::number(reinterpret_cast<quintptr>(sock)));
-    sock->deleteLater();
-    qInfo() << "Client disconnected:" << sock;
+    m_consumer->setRefreshRate(hz);
 }
 
-void WDLDriverServer::processMessages(ClientCtx& ctx)
+void WDLDriverServer::setCaptureFile(const QString& path)
 {
-    MessageType type;
-    QByteArray payload;
-
-    // Processa enquanto existir uma mensagem completa no buffer
-    while (tryUnpack(ctx.buffer, type, payload)) {
-        handleMessage(ctx.socket, type, payload);
+    m_capture.reset(path.isEmpty() ? nullptr : new CaptureWriter(path));
+    for (WDLIoWorker* worker : m_workers) {
+        worker->setCapture(m_capture.data());
     }
 }
 
-void WDLDriverServer::handleMessage(QLocalSocket* sock, MessageType type, const QByteArray& payload)
+WDLIoWorker* WDLDriverServer::leastLoadedWorker() const
 {
-    switch (type) {
-    case MessageType::Ping: {
-        QByteArray pong = pack(MessageType::Pong, QByteArray());
-        if (sock) sock->write(pong);
-        break;
-    }
-    case MessageType::SetLedColors: {
-        // TODO: integrar com driver virtual futuramente
-        qInfo() << "Received SetLedColors with" << (payload.size() / 3) << "RGB triplets";
-        break;
-    }
-    case MessageType::SetBrightness: {
-        if (payload.size() >= static_cast<int>(sizeof(float))) {
-            float value = 1.0f;
-            memcpy(&value, payload.constData(), sizeof(float));
-            qInfo() << "Received SetBrightness:" << value;
+    // Menos clientes; empate decidido pelo tempo de processamento acumulado
+    WDLIoWorker* best = nullptr;
+    for (WDLIoWorker* worker : m_workers) {
+        if (!best) {
+            best = worker;
+            continue;
+        }
+        const int clients = worker->load().clients.load(std::memory_order_relaxed);
+        const int bestClients = best->load().clients.load(std::memory_order_relaxed);
+        if (clients < bestClients
+            || (clients == bestClients
+                && worker->load().busyNs.load(std::memory_order_relaxed) < best->load().busyNs.load(std::memory_order_relaxed))) {
+            best = worker;
         }
-        break;
-    }
-    case MessageType::GetStatus: {
-        QByteArray status = QByteArray("{\"status\":\"ok\",\"connectedClients\":"
-                                       + QByteArray::number(m_clients.size()) + "}");
-        QByteArray msg = pack(MessageType::StatusResponse, status);
-        if (sock) sock->write(msg);
-        break;
-    }
-    default:
-        qWarning() << "Unknown message type:" << static_cast<int>(type);
-        break;
     }
+    return best;
+}
+
+void WDLDriverServer::onIncomingDescriptor(quintptr socketDescriptor)
+{
+    WDLIoWorker* worker = leastLoadedWorker();
+    if (!worker) return;
+
+    const quint64 id = m_nextClientId++;
+    // Contabilizado já na atribuição para que conexões em rajada se distribuam
+    worker->load().clients.fetch_add(1, std::memory_order_relaxed);
+    QMetaObject::invokeMethod(worker, [worker, socketDescriptor, id]() {
+        worker->addClient(socketDescriptor, id);
+    }, Qt::QueuedConnection);
 }
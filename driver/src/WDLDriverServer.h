@@ -3,47 +3,80 @@
 
 #include <QObject>
 #include <QLocalServer>
-#include <QLocalSocket>
-#include <QPointer>
-#include <QHash>
-#include <QByteArray>
-#include <QTimer>
-#include <QElapsedTimer>
+#include <QThread>
+#include <QVector>
 
-#include "../common/DriverProtocol.h"
+#include "WDLIoWorker.h"
+#include "WDLFrameConsumer.h"
+#include "DriverMetrics.h"
+#include "CaptureWriter.h"
 
+#include <QScopedPointer>
+
+// QLocalServer que entrega o descritor da conexão em vez de criar o
+// QLocalSocket na thread principal; o socket é criado na thread do worker.
+class WDLLocalServer : public QLocalServer
+{
+    Q_OBJECT
+public:
+    using QLocalServer::QLocalServer;
+
+signals:
+    void incomingDescriptor(quintptr socketDescriptor);
+
+protected:
+    void incomingConnection(quintptr socketDescriptor) override
+    {
+        emit incomingDescriptor(socketDescriptor);
+    }
+};
+
+// Aceita conexões na thread principal e distribui cada cliente para o
+// worker de I/O menos carregado. Frames decodificados seguem dos workers
+// para o WDLFrameConsumer por filas lock-free.
 class WDLDriverServer : public QObject
 {
     Q_OBJECT
 public:
-    explicit WDLDriverServer(const QString& serverName, QObject* parent = nullptr);
+    // workerCount <= 0: escolhido a partir dos núcleos disponíveis
+    explicit WDLDriverServer(const QString& serverName, int workerCount = 0, QObject* parent = nullptr);
     ~WDLDriverServer();
 
     bool start();
     void stop();
 
+    int workerCount() const { return m_workers.size(); }
+
+    // Latest-frame-wins (padrão). Desligado, todo frame recebido é aplicado
+    // em ordem. Deve ser chamado antes de start().
+    void setCoalescing(bool enabled);
+
+    // Ticks de apresentação por segundo (ver WDLFrameConsumer); 0 aplica
+    // os frames ao chegar. Deve ser chamado antes de start().
+    void setRefreshRate(int hz);
+
+    // Grava toda mensagem recebida em 'path' (ver CaptureFormat.h). Deve
+    // ser chamado antes de start(); vazio desliga.
+    void setCaptureFile(const QString& path);
+
 signals:
     void clientConnected(const QString& id);
     void clientDisconnected(const QString& id);
 
 private slots:
-    void onNewConnection();
-    void onReadyRead();
-    void onSocketError(QLocalSocket::LocalSocketError);
-    void onDisconnected();
+    void onIncomingDescriptor(quintptr socketDescriptor);
 
 private:
-    struct ClientCtx {
-        QPointer<QLocalSocket> socket;
-        QByteArray buffer; // acumula dados para framing
-    };
-
     QString m_serverName;
-    QLocalServer m_server;
-    QHash<QLocalSocket*, ClientCtx> m_clients;
+    WDLLocalServer m_server;
+    DriverMetrics::MetricsRegistry m_metrics;
+    QScopedPointer<CaptureWriter> m_capture;
+    WDLFrameConsumer* m_consumer = nullptr;
+    QVector<WDLIoWorker*> m_workers;
+    QVector<QThread*> m_threads;
+    quint64 m_nextClientId = 1;
 
-    void processMessages(ClientCtx& ctx);
-    void handleMessage(QLocalSocket* sock, DriverProtocol::MessageType type, const QByteArray& payload);
+    WDLIoWorker* leastLoadedWorker() const;
 };
 
 #endif // WDL_DRIVER_SERVER_H
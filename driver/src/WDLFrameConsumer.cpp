@@ -0,0 +1,221 @@
+#include "WDLFrameConsumer.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+
+WDLFrameConsumer::WDLFrameConsumer(int producerCount, quint32 queueCapacity, QObject* parent)
+    : QThread(parent)
+{
+    m_queues.reserve(static_cast<size_t>(producerCount));
+    for (int i = 0; i < producerCount; ++i) {
+        m_queues.emplace_back(new ConsumerQueue(queueCapacity));
+    }
+    setObjectName("WDL consumer");
+}
+
+WDLFrameConsumer::~WDLFrameConsumer()
+{
+    stop();
+}
+
+void WDLFrameConsumer::start(QThread::Priority priority)
+{
+    if (isRunning()) return;
+    m_running.store(true, std::memory_order_release);
+    QThread::start(priority);
+}
+
+void WDLFrameConsumer::stop()
+{
+    if (!isRunning()) return;
+    m_running.store(false, std::memory_order_release);
+    m_wake.release();
+    wait();
+}
+
+void WDLFrameConsumer::run()
+{
+    // m_running é ligado em start() e desligado em stop(); aqui só é lido
+    if (m_refreshHz > 0) {
+        runPaced();
+    } else {
+        while (m_running.load(std::memory_order_acquire)) {
+            // Sem prazo: produtores e stop() liberam o semáforo
+            m_wake.acquire();
+            drainAll();
+            // Notificações já atendidas por este drain
+            const int pending = m_wake.available();
+            if (pending > 0) m_wake.tryAcquire(pending);
+        }
+    }
+
+    drainAll();
+}
+
+void WDLFrameConsumer::setFineTimer(bool enable)
+{
+    if (m_fineTimer == enable) return;
+    m_fineTimer = enable;
+#ifdef Q_OS_WIN
+    // Sleeps de ~1 ms em vez do quantum padrão de ~15,6 ms, só enquanto há
+    // frames a cadenciar (o ajuste vale para o sistema todo)
+    if (enable) {
+        timeBeginPeriod(1);
+    } else {
+        timeEndPeriod(1);
+    }
+#endif
+}
+
+void WDLFrameConsumer::runPaced()
+{
+    const qint64 period = 1000000000 / m_refreshHz;
+    m_pacer.setLateToleranceNs(period);
+    qint64 nextTick = DriverMetrics::monotonicNs() + period;
+
+    while (m_running.load(std::memory_order_acquire)) {
+        const qint64 due = m_pacer.nextDueNs();
+        if (due == FramePacer::NoneDue) {
+            // Nada a apresentar: bloqueia até um produtor (ou stop()) acordar
+            setFineTimer(false);
+            m_wake.acquire();
+            drainAll();
+            const int pending = m_wake.available();
+            if (pending > 0) m_wake.tryAcquire(pending);
+
+            // Mantém a fase da grade; ticks ociosos não contam como perdidos
+            const qint64 now = DriverMetrics::monotonicNs();
+            if (nextTick <= now) nextTick += ((now - nextTick) / period + 1) * period;
+            continue;
+        }
+        setFineTimer(true);
+
+        // Tick em que o frame mais próximo vence; os anteriores não têm o
+        // que apresentar e são pulados
+        const qint64 target = due > nextTick ? nextTick + ((due - nextTick + period - 1) / period) * period : nextTick;
+
+        // Dorme no semáforo (acordando para drenar as filas) até restar a
+        // janela final, que é feita girando
+        const qint64 remaining = target - DriverMetrics::monotonicNs();
+        const qint64 sleepMs = (remaining - SpinWindowNs) / 1000000;
+        if (sleepMs > 0) {
+            m_wake.tryAcquire(1, static_cast<int>(qMin<qint64>(sleepMs, 100)));
+        } else if (remaining > 0) {
+            QThread::yieldCurrentThread();
+        }
+
+        drainAll();
+        const int pending = m_wake.available();
+        if (pending > 0) m_wake.tryAcquire(pending);
+
+        // Um frame novo pode vencer antes: o próximo passo recalcula o alvo
+        const qint64 now = DriverMetrics::monotonicNs();
+        if (now < target) continue;
+
+        m_pacer.present(target, now, m_lamps);
+        nextTick = target + period;
+        if (now >= nextTick) {
+            // Atraso de períodos inteiros: realinha em vez de disparar ticks em rajada
+            const qint64 missed = (now - nextTick) / period + 1;
+            m_pacer.stats().ticksMissed.fetch_add(static_cast<quint64>(missed), std::memory_order_relaxed);
+            nextTick += missed * period;
+        }
+    }
+
+    setFineTimer(false);
+}
+
+int WDLFrameConsumer::drainAll()
+{
+    int items = 0;
+    for (auto& q : m_queues) {
+        items += drainQueue(*q);
+    }
+    return items;
+}
+
+int WDLFrameConsumer::drainQueue(ConsumerQueue& q)
+{
+    // Lote fixado no início: o que chegar durante o drain fica para a
+    // próxima passada
+    quint32 count = 0;
+    while (q.peek(count)) ++count;
+    if (count == 0) return 0;
+
+    // Um cliente vive em um único worker, logo seus frames estão todos
+    // nesta fila: basta a última posição de cada um dentro do lote
+    m_latestFrame.resize(0);
+    if (m_coalesce) {
+        for (quint32 i = 0; i < count; ++i) {
+            const ConsumerItem* item = q.peek(i);
+            // Frames com horário ocupam cada um o seu instante: não coalescem
+            if (item->kind != ConsumerItem::Kind::Frame || item->presentAtNs != 0) continue;
+            bool found = false;
+            for (auto& latest : m_latestFrame) {
+                if (latest.first == item->clientId) {
+                    latest.second = i;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) m_latestFrame.append(qMakePair(item->clientId, i));
+        }
+    }
+
+    quint64 superseded = 0;
+    for (quint32 i = 0; i < count; ++i) {
+        ConsumerItem* item = q.front();
+        bool skip = false;
+        if (m_coalesce && item->kind == ConsumerItem::Kind::Frame && item->presentAtNs == 0) {
+            for (const auto& latest : m_latestFrame) {
+                if (latest.first == item->clientId) {
+                    skip = latest.second != i;
+                    break;
+                }
+            }
+        }
+        // Controle (brilho, desconexão) é sempre aplicado, na ordem
+        if (skip) {
+            ++superseded;
+            if (item->metrics) item->metrics->framesSuperseded.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            apply(*item);
+        }
+        q.pop();
+    }
+
+    if (superseded > 0) m_framesSuperseded.fetch_add(superseded, std::memory_order_relaxed);
+    return static_cast<int>(count);
+}
+
+void WDLFrameConsumer::apply(ConsumerItem& item)
+{
+    switch (item.kind) {
+    case ConsumerItem::Kind::Frame: {
+        if (m_refreshHz > 0) {
+            m_pacer.enqueue(item, DriverMetrics::monotonicNs());
+            break;
+        }
+        // Lido direto do slot: o buffer volta para a fila com a capacidade
+        m_lamps.applyFrame(item.clientId, item.colors, item.layout);
+        if (item.metrics) {
+            item.metrics->framesApplied.fetch_add(1, std::memory_order_relaxed);
+            item.metrics->latencyNs.record(static_cast<quint64>(DriverMetrics::monotonicNs() - item.receivedNs));
+        }
+        break;
+    }
+    case ConsumerItem::Kind::Brightness:
+        // Com cadência, frames anteriores ainda na linha do tempo saem antes
+        if (m_refreshHz == 0 || !m_pacer.deferBrightness(item.clientId, item.brightness)) {
+            m_lamps.setBrightness(item.clientId, item.brightness);
+        }
+        m_brightnessChanges.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case ConsumerItem::Kind::ClientGone:
+        m_pacer.removeClient(item.clientId);
+        m_lamps.removeClient(item.clientId);
+        break;
+    }
+}
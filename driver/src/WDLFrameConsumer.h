@@ -0,0 +1,117 @@
+#ifndef WDL_FRAME_CONSUMER_H
+#define WDL_FRAME_CONSUMER_H
+
+#include <QThread>
+#include <QSemaphore>
+#include <QHash>
+#include <QByteArray>
+#include <QVector>
+#include <QPair>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "SpscQueue.h"
+#include "DriverMetrics.h"
+#include "LampArrayStore.h"
+#include "FramePacer.h"
+#include "../common/DeviceFrame.h"
+
+// Item entregue pelos workers de I/O ao estágio consumidor. Os slots da
+// fila são reutilizados: colors/layout mantêm a capacidade entre usos.
+struct ConsumerItem {
+    enum class Kind : quint8 {
+        Frame,      // frame completo materializado (keyframe ou delta aplicado)
+        Brightness,
+        ClientGone  // conexão encerrada: descartar o estado do cliente
+    };
+
+    Kind kind = Kind::Frame;
+    quint64 clientId = 0;
+    QByteArray colors;                                // RGB888 do frame inteiro
+    QVector<DriverProtocol::DeviceFrameEntry> layout; // vazio = frame plano
+    float brightness = 1.0f;
+    qint64 receivedNs = 0;                            // DriverMetrics::monotonicNs() da leitura
+    qint64 presentAtNs = 0;                           // TimedFrame; 0 = no próximo tick
+    QSharedPointer<DriverMetrics::ClientMetrics> metrics;
+};
+
+using ConsumerQueue = SpscQueue<ConsumerItem>;
+
+// Estágio consumidor: thread única que drena as filas SPSC de todos os
+// workers (uma fila por worker, logo um único produtor por fila) e aplica
+// frames e brilho ao LampArrayStore. Os workers acordam a thread via notify().
+//
+// Com refresh rate definido, os frames passam pelo FramePacer e a saída é
+// cadenciada por um agendador de alta resolução: a thread dorme no semáforo
+// até perto do tick do próximo frame vencido e gira só a fração final.
+// Sem frames na linha do tempo ela bloqueia sem prazo (nem timer de 1 ms
+// nem espera ativa): um driver ocioso não consome CPU.
+class WDLFrameConsumer : public QThread
+{
+    Q_OBJECT
+public:
+    explicit WDLFrameConsumer(int producerCount, quint32 queueCapacity = 256, QObject* parent = nullptr);
+    ~WDLFrameConsumer();
+
+    ConsumerQueue& queue(int producer) { return *m_queues[static_cast<size_t>(producer)]; }
+    int producerCount() const { return static_cast<int>(m_queues.size()); }
+
+    // Chamado pelos produtores após commitPush()
+    void notify() { m_wake.release(); }
+
+    // Marca a thread como ativa antes de QThread::start(): um stop() logo
+    // em seguida não pode ser sobrescrito pela thread recém-criada
+    void start(QThread::Priority priority = QThread::InheritPriority);
+    void stop();
+
+    // Latest-frame-wins: de vários frames pendentes do mesmo cliente em
+    // uma fila, só o mais novo é aplicado. Definido antes de start().
+    void setCoalescing(bool enabled) { m_coalesce = enabled; }
+    bool coalescing() const { return m_coalesce; }
+    quint64 framesSuperseded() const { return m_framesSuperseded.load(std::memory_order_relaxed); }
+    // Mudanças de brilho recebidas (contadas em vez de logadas: arrastar o
+    // slider gera uma por tick da UI)
+    quint64 brightnessChanges() const { return m_brightnessChanges.load(std::memory_order_relaxed); }
+
+    // Ticks de apresentação por segundo. 0 desliga a cadência: frames são
+    // aplicados ao chegar e os horários de TimedFrame são ignorados.
+    // Definido antes de start().
+    void setRefreshRate(int hz) { m_refreshHz = qMax(0, hz); }
+    int refreshRate() const { return m_refreshHz; }
+    const PresentationStats& presentationStats() const { return m_pacer.stats(); }
+
+    // Estado dos LampArrays virtuais; snapshots podem ser tirados de qualquer thread
+    const LampArrayStore& lamps() const { return m_lamps; }
+
+protected:
+    void run() override;
+
+private:
+    std::vector<std::unique_ptr<ConsumerQueue>> m_queues;
+    QSemaphore m_wake;
+    std::atomic<bool> m_running { false };
+    bool m_coalesce = true;
+    int m_refreshHz = 0;
+    std::atomic<quint64> m_framesSuperseded { 0 };
+    std::atomic<quint64> m_brightnessChanges { 0 };
+
+    LampArrayStore m_lamps;
+
+    // Acessado apenas pela thread consumidora
+    QVector<QPair<quint64, quint32>> m_latestFrame; // cliente -> posição do último frame no lote
+    FramePacer m_pacer;
+
+    // Margem final do tick feita em espera ativa (abaixo da granularidade do sleep)
+    static constexpr qint64 SpinWindowNs = 1000000;
+
+    bool m_fineTimer = false; // timeBeginPeriod(1) ativo
+    void setFineTimer(bool enable);
+    void runPaced();
+    int drainAll();
+    int drainQueue(ConsumerQueue& q);
+    void apply(ConsumerItem& item);
+};
+
+#endif // WDL_FRAME_CONSUMER_H
@@ -0,0 +1,487 @@
+#include "WDLIoWorker.h"
+
+#include <QDebug>
+
+using namespace DriverProtocol;
+
+WDLIoWorker::WDLIoWorker(int index, WDLFrameConsumer* consumer, DriverMetrics::MetricsRegistry* registry, QObject* parent)
+    : QObject(parent)
+    , m_index(index)
+    , m_consumer(consumer)
+    , m_queue(consumer->queue(index))
+    , m_registry(registry)
+{
+    // Capacidade reservada: resize(0) entre respostas não libera o buffer
+    m_txScratch.reserve(4096);
+}
+
+WDLIoWorker::~WDLIoWorker()
+{
+    shutdown();
+}
+
+void WDLIoWorker::addClient(quintptr socketDescriptor, quint64 clientId)
+{
+    QLocalSocket* sock = new QLocalSocket(this);
+    if (!sock->setSocketDescriptor(static_cast<qintptr>(socketDescriptor))) {
+        qWarning() << "Worker" << m_index << "failed to adopt client" << clientId << ":" << sock->errorString();
+        m_load.clients.fetch_sub(1, std::memory_order_relaxed);
+        delete sock;
+        return;
+    }
+
+    ClientCtx& ctx = m_clients[sock];
+    ctx.id = clientId;
+    ctx.socket = sock;
+    ctx.metrics.reset(new DriverMetrics::ClientMetrics);
+    ctx.metrics->clientId = clientId;
+    ctx.metrics->worker = m_index;
+    m_registry->add(ctx.metrics);
+
+    connect(sock, &QLocalSocket::readyRead, this, &WDLIoWorker::onReadyRead);
+    connect(sock, &QLocalSocket::errorOccurred, this, &WDLIoWorker::onSocketError);
+    connect(sock, &QLocalSocket::disconnected, this, &WDLIoWorker::onDisconnected);
+
+    emit clientConnected(clientId);
+    qInfo() << "Client" << clientId << "connected on worker" << m_index;
+}
+
+void WDLIoWorker::shutdown()
+{
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        if (it.key()) {
+            it.key()->disconnect(this);
+            it.key()->abort();
+            delete it.key();
+        }
+        m_registry->remove(it.value().id);
+        m_load.clients.fetch_sub(1, std::memory_order_relaxed);
+    }
+    m_clients.clear();
+}
+
+void WDLIoWorker::onReadyRead()
+{
+    QLocalSocket* sock = qobject_cast<QLocalSocket*>(sender());
+    if (!sock || !m_clients.contains(sock)) return;
+
+    m_batchNs = DriverMetrics::monotonicNs();
+    if (!m_controlOverflow.isEmpty()) flushControl();
+
+    ClientCtx& ctx = m_clients[sock];
+    DriverMetrics::ClientMetrics& metrics = *ctx.metrics;
+
+    // Lê direto para a arena do framer, sem QByteArray intermediário
+    const qint64 available = sock->bytesAvailable();
+    if (available > 0) {
+        DriverMetrics::updateMax(metrics.maxBacklogBytes, static_cast<quint32>(qMin<qint64>(available, 0xFFFFFFFF)));
+        char* dst = ctx.framer.prepareWrite(static_cast<int>(available));
+        const qint64 n = sock->read(dst, available);
+        if (n > 0) {
+            ctx.framer.commitWrite(static_cast<int>(n));
+            m_load.bytesIn.fetch_add(static_cast<quint64>(n), std::memory_order_relaxed);
+            metrics.bytes.add(static_cast<quint64>(n));
+        }
+    }
+
+    // Processa todos os frames completos do lote em uma única passada.
+    // Uma leitura de relógio por mensagem: o fim de uma é o início da próxima.
+    qint64 t = m_batchNs;
+    const int frames = ctx.framer.consume([this, &ctx, &metrics, &t](MessageType type, const PayloadView& payload) {
+        handleMessage(ctx, type, payload);
+        const qint64 now = DriverMetrics::monotonicNs();
+        metrics.parseNs.record(static_cast<quint64>(now - t));
+        t = now;
+    });
+    if (ctx.framePending) {
+        ctx.framePending = false;
+        pushFrame(ctx);
+    }
+
+    const qint64 now = DriverMetrics::monotonicNs();
+    metrics.messages.fetch_add(static_cast<quint64>(frames), std::memory_order_relaxed);
+    metrics.frames.tick(now);
+    metrics.bytes.tick(now);
+    m_load.messages.fetch_add(static_cast<quint64>(frames), std::memory_order_relaxed);
+    m_load.busyNs.fetch_add(static_cast<quint64>(now - m_batchNs), std::memory_order_relaxed);
+
+    // Cabeçalho inválido: stream fora de sincronia, descartar o cliente.
+    // Último uso de ctx: abort() dispara onDisconnected, que o remove.
+    if (ctx.framer.hasError()) {
+        qWarning() << "Dropping client" << ctx.id << "after malformed frame header"
+                   << (ctx.framer.error() == Framer::Error::FrameTooLarge ? "(too large)" : "(too short)");
+        sock->abort();
+    }
+}
+
+void WDLIoWorker::onSocketError(QLocalSocket::LocalSocketError)
+{
+    QLocalSocket* sock = qobject_cast<QLocalSocket*>(sender());
+    if (!sock) return;
+    qWarning() << "Socket error:" << sock->errorString();
+}
+
+void WDLIoWorker::onDisconnected()
+{
+    QLocalSocket* sock = qobject_cast<QLocalSocket*>(sender());
+    if (!sock || !m_clients.contains(sock)) return;
+
+    const quint64 id = m_clients.value(sock).id;
+    m_clients.remove(sock);
+    m_registry->remove(id);
+    m_load.clients.fetch_sub(1, std::memory_order_relaxed);
+    pushControl(ConsumerItem::Kind::ClientGone, id);
+
+    emit clientDisconnected(id);
+    sock->deleteLater();
+    qInfo() << "Client" << id << "disconnected from worker" << m_index;
+}
+
+void WDLIoWorker::submitFrame(ClientCtx& ctx)
+{
+    // O delta/keyframe já foi aplicado à referência; o frame pendente
+    // anterior deixa de existir
+    if (ctx.framePending) {
+        ctx.metrics->framesSuperseded.fetch_add(1, std::memory_order_relaxed);
+        m_load.framesSuperseded.fetch_add(1, std::memory_order_relaxed);
+        ctx.framePending = false;
+    }
+
+    // Só um horário ainda no futuro ocupa o seu instante; frame já vencido
+    // (ao vivo: presentAtNs = sentNs) vale como sem horário e coalesce
+    if (!m_coalesce || ctx.presentAtNs > m_batchNs) {
+        pushFrame(ctx);
+        return;
+    }
+    ctx.framePending = true;
+}
+
+void WDLIoWorker::pushFrame(const ClientCtx& ctx)
+{
+    // Controle ainda à espera (p. ex. brilho) vai antes; sem espaço para
+    // ele, também não há para o frame
+    ConsumerItem* item = m_controlOverflow.isEmpty() || flushControl() ? m_queue.beginPush() : nullptr;
+    if (!item) {
+        m_load.queueDrops.fetch_add(1, std::memory_order_relaxed);
+        ctx.metrics->framesDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    item->kind = ConsumerItem::Kind::Frame;
+    item->clientId = ctx.id;
+    item->receivedNs = m_batchNs;
+    item->presentAtNs = ctx.presentAtNs;
+    item->metrics = ctx.metrics;
+    const int size = ctx.referenceFrame.size();
+    // reserve() antes do resize: o slot mantém a capacidade entre usos
+    if (item->colors.capacity() < size) item->colors.reserve(size);
+    item->colors.resize(size);
+    if (size > 0) memcpy(item->colors.data(), ctx.referenceFrame.constData(), static_cast<size_t>(size));
+    item->layout = ctx.layout; // compartilhado implicitamente, sem cópia
+
+    m_queue.commitPush();
+    DriverMetrics::updateMax(ctx.metrics->maxQueueDepth, m_queue.size());
+    m_consumer->notify();
+}
+
+void WDLIoWorker::pushControl(ConsumerItem::Kind kind, quint64 clientId, float brightness)
+{
+    // Entra atrás do que já estiver à espera: a ordem do cliente é mantida
+    m_controlOverflow.append({ kind, clientId, brightness, m_batchNs });
+    if (!flushControl()) {
+        m_load.controlDeferred.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool WDLIoWorker::flushControl()
+{
+    // Consumidor parado (encerramento): não há mais quem receba
+    if (!m_consumer->isRunning()) {
+        m_controlOverflow.clear();
+        return true;
+    }
+
+    int sent = 0;
+    while (sent < m_controlOverflow.size()) {
+        ConsumerItem* item = m_queue.beginPush();
+        if (!item) break;
+
+        const PendingControl& pending = m_controlOverflow[sent];
+        item->kind = pending.kind;
+        item->clientId = pending.clientId;
+        item->brightness = pending.brightness;
+        item->receivedNs = pending.receivedNs;
+        item->presentAtNs = 0;
+        item->metrics.reset();
+        m_queue.commitPush();
+        ++sent;
+    }
+    if (sent > 0) {
+        m_controlOverflow.remove(0, sent);
+        m_consumer->notify();
+    }
+
+    if (m_controlOverflow.isEmpty()) {
+        if (m_controlRetry) m_controlRetry->stop();
+        return true;
+    }
+
+    // Sem novo lote (cliente ocioso ou desconectado) o timer reenvia
+    if (!m_controlRetry) {
+        m_controlRetry = new QTimer(this);
+        m_controlRetry->setSingleShot(true);
+        connect(m_controlRetry, &QTimer::timeout, this, [this]() { flushControl(); });
+    }
+    if (!m_controlRetry->isActive()) m_controlRetry->start(ControlRetryMs);
+    return false;
+}
+
+void WDLIoWorker::handleMessage(ClientCtx& ctx, MessageType type, const PayloadView& payload)
+{
+    QLocalSocket* sock = ctx.socket;
+
+    // Frames do anel são gravados como mensagens inline; a sinalização do
+    // transporte compartilhado não tem significado fora desta sessão. O
+    // frame interno de um TimedFrame já foi gravado com o envelope.
+    if (m_capture && type != MessageType::OpenSharedTransport && type != MessageType::FrameDoorbell
+        && !ctx.inEnvelope) {
+        m_capture->record(ctx.id, type, payload);
+    }
+
+    // Inclui frames drenados do anel compartilhado; o envelope de
+    // TimedFrame é contado pelo frame interno
+    if (isFrameMessage(type) && type != MessageType::TimedFrame) {
+        ctx.metrics->frames.add(1);
+        ctx.metrics->frameBytes.record(static_cast<quint64>(payload.size));
+    }
+
+    switch (type) {
+    case MessageType::Ping: {
+        qint64 sentNs = 0;
+        if (PingStampedMsg::decode(payload, sentNs)) {
+            reply<PongStampedMsg>(sock, sentNs, DriverMetrics::monotonicNs());
+        } else {
+            reply<PongMsg>(sock);
+        }
+        break;
+    }
+    case MessageType::Hello: {
+        Capabilities remote;
+        if (!remote.decode(payload)) {
+            qWarning() << "Malformed Hello (" << payload.size << "bytes)";
+            break;
+        }
+        ctx.caps = Capabilities::negotiate(localCapabilities(), remote);
+        ctx.helloReceived = true;
+        // Limite negociado vale para o stream: frames acima dele derrubam a conexão
+        ctx.framer.setMaxFrameSize(ctx.caps.maxFrameSize);
+        qInfo() << "Client" << ctx.id << "negotiated" << ctx.caps.describe();
+        m_txScratch.resize(0);
+        ctx.caps.packInto(m_txScratch, MessageType::HelloAck);
+        if (sock) sock->write(m_txScratch);
+        break;
+    }
+    case MessageType::SetLedColors: {
+        // Keyframe: vira a nova referência da conexão (reaproveita a capacidade)
+        ctx.referenceFrame.resize(payload.size);
+        if (payload.size > 0) {
+            memcpy(ctx.referenceFrame.data(), payload.data, static_cast<size_t>(payload.size));
+        }
+        ctx.layout.clear(); // frame plano, sem endereçamento por dispositivo
+        ctx.keyframeRequested = false;
+        submitFrame(ctx);
+        break;
+    }
+    case MessageType::SetDeviceFrame: {
+        DeviceFrameView frame;
+        if (!frame.parse(payload)) {
+            qWarning() << "Malformed SetDeviceFrame (" << payload.size << "bytes)";
+            break;
+        }
+
+        // Keyframe endereçado: bloco de cores vira a referência dos deltas
+        const PayloadView& colors = frame.colors();
+        ctx.referenceFrame.resize(colors.size);
+        if (colors.size > 0) {
+            memcpy(ctx.referenceFrame.data(), colors.data, static_cast<size_t>(colors.size));
+        }
+
+        // Layout só é realocado quando muda (o consumidor compartilha o anterior)
+        bool sameLayout = ctx.layout.size() == frame.entryCount();
+        for (int i = 0; sameLayout && i < frame.entryCount(); ++i) {
+            sameLayout = ctx.layout.at(i) == frame.entry(i);
+        }
+        if (!sameLayout) {
+            ctx.layout.resize(frame.entryCount());
+            for (int i = 0; i < frame.entryCount(); ++i) {
+                ctx.layout[i] = frame.entry(i);
+            }
+        }
+
+        ctx.keyframeRequested = false;
+        submitFrame(ctx);
+        break;
+    }
+    case MessageType::SetLedColorsDelta: {
+        if (!applyDelta(ctx.referenceFrame, payload)) {
+            // Sem referência compatível (ex.: reconexão): pedir keyframe uma
+            // vez; os deltas ainda em trânsito só entram no contador
+            ctx.metrics->deltasRejected.fetch_add(1, std::memory_order_relaxed);
+            if (!ctx.keyframeRequested) {
+                ctx.keyframeRequested = true;
+                qWarning() << "Client" << ctx.id << "rejected SetLedColorsDelta; requesting keyframe";
+                reply<RequestKeyframeMsg>(sock);
+            }
+            break;
+        }
+        ++ctx.deltasApplied;
+        submitFrame(ctx);
+        break;
+    }
+    case MessageType::TimedFrame: {
+        FrameStamp stamp;
+        MessageType frameType = MessageType::SetLedColors;
+        PayloadView frame;
+        if (!parseTimedFrame(payload, stamp, frameType, frame)) {
+            // Contador por conexão; o log avisa só na primeira
+            ctx.metrics->timedFramesMalformed.fetch_add(1, std::memory_order_relaxed);
+            if (!ctx.timedFrameWarned) {
+                ctx.timedFrameWarned = true;
+                qWarning() << "Client" << ctx.id << "sent a malformed TimedFrame (" << payload.size
+                           << "bytes); further ones are only counted";
+            }
+            break;
+        }
+        // Recepção = leitura do lote, antes de qualquer fila do driver
+        reply<FrameAckMsg>(sock, stamp.seq, stamp.sentNs, m_batchNs);
+
+        ctx.inEnvelope = true;
+        ctx.presentAtNs = qMax<qint64>(stamp.presentAtNs, 0);
+        handleMessage(ctx, frameType, frame);
+        ctx.presentAtNs = 0;
+        ctx.inEnvelope = false;
+        break;
+    }
+    case MessageType::SetBrightness: {
+        float value = 1.0f;
+        if (SetBrightnessMsg::decode(payload, value)) {
+            pushControl(ConsumerItem::Kind::Brightness, ctx.id, value);
+        }
+        break;
+    }
+    case MessageType::OpenSharedTransport: {
+        bool accepted = false;
+        // Após o Hello, só aceita se o transporte fez parte da negociação
+        const bool allowed = !ctx.helloReceived || ctx.caps.has(TransportSharedMemory);
+        if (allowed && payload.size >= static_cast<int>(sizeof(quint16))) {
+            const quint16 len = qFromLittleEndian<quint16>(payload.data);
+            if (payload.size >= static_cast<int>(sizeof(quint16)) + len) {
+                const QString name = QString::fromUtf8(payload.data + sizeof(quint16), len);
+                QSharedPointer<SharedFrameRing> ring(new SharedFrameRing);
+                if (ring->open(name)) {
+                    ctx.ring = ring;
+                    accepted = true;
+                }
+                qInfo() << "Shared frame transport" << name << (accepted ? "opened" : "unavailable");
+            }
+        }
+        reply<SharedTransportAckMsg>(sock, static_cast<quint8>(accepted ? 1 : 0));
+        break;
+    }
+    case MessageType::FrameDoorbell: {
+        quint64 seq = 0;
+        if (!ctx.ring || !FrameDoorbellMsg::decode(payload, seq)) break;
+
+        // Slot perdido (anel deu a volta ou escrita em andamento): se era um
+        // delta, a referência ficaria errada sem aviso, já que o delta só
+        // confere o ledCount. A referência é descartada no ponto da perda,
+        // então deltas seguintes são rejeitados até o keyframe pedido abaixo
+        const quint64 droppedBefore = ctx.ring->droppedFrames();
+        bool referenceLost = false;
+        ctx.ring->drain(seq, ctx.ringScratch, [this, &ctx, droppedBefore, &referenceLost](MessageType frameType, const PayloadView& frame) {
+            if (!referenceLost && ctx.ring->droppedFrames() != droppedBefore) {
+                referenceLost = true;
+                ctx.referenceFrame.clear();
+            }
+            // Só frames de LED trafegam pelo anel
+            if (isFrameMessage(frameType)) handleMessage(ctx, frameType, frame);
+        });
+        if (ctx.ring->droppedFrames() != droppedBefore) {
+            if (!referenceLost) ctx.referenceFrame.clear();
+            if (!ctx.keyframeRequested) {
+                ctx.keyframeRequested = true;
+                qWarning() << "Client" << ctx.id << "lost" << (ctx.ring->droppedFrames() - droppedBefore)
+                           << "shared ring frames; requesting keyframe";
+                reply<RequestKeyframeMsg>(sock);
+            }
+        }
+        break;
+    }
+    case MessageType::GetStatus: {
+        const QByteArray status = statusJson(ctx);
+        m_txScratch.resize(0);
+        packInto(m_txScratch, MessageType::StatusResponse, status.constData(), status.size());
+        if (sock) sock->write(m_txScratch);
+        break;
+    }
+    case MessageType::GetStats: {
+        m_txScratch.resize(0);
+        ctx.metrics->snapshot(DriverMetrics::monotonicNs()).packInto(m_txScratch);
+        if (sock) sock->write(m_txScratch);
+        break;
+    }
+    default:
+        qWarning() << "Unknown message type:" << static_cast<int>(type);
+        break;
+    }
+}
+
+QByteArray WDLIoWorker::statusJson(const ClientCtx& ctx) const
+{
+    int connected = 0;
+    QByteArray workers;
+    for (const WDLIoWorker* w : m_peers) {
+        const WorkerLoad& l = w->load();
+        const int clients = l.clients.load(std::memory_order_relaxed);
+        connected += clients;
+        if (!workers.isEmpty()) workers += ',';
+        workers += "{\"clients\":" + QByteArray::number(clients)
+                 + ",\"messages\":" + QByteArray::number(l.messages.load(std::memory_order_relaxed))
+                 + ",\"bytesIn\":" + QByteArray::number(l.bytesIn.load(std::memory_order_relaxed))
+                 + ",\"busyMs\":" + QByteArray::number(l.busyNs.load(std::memory_order_relaxed) / 1000000)
+                 + ",\"queueDrops\":" + QByteArray::number(l.queueDrops.load(std::memory_order_relaxed))
+                 + ",\"framesSuperseded\":" + QByteArray::number(l.framesSuperseded.load(std::memory_order_relaxed))
+                 + ",\"controlDeferred\":" + QByteArray::number(l.controlDeferred.load(std::memory_order_relaxed)) + "}";
+    }
+
+    // Métricas de todas as conexões, inclusive as de outros workers
+    const qint64 now = DriverMetrics::monotonicNs();
+    QByteArray clients;
+    for (const auto& metrics : m_registry->clients()) {
+        if (!clients.isEmpty()) clients += ',';
+        clients += metrics->toJson(now);
+    }
+
+    QByteArray capture("null");
+    if (m_capture && m_capture->isOpen()) {
+        capture = "{\"records\":" + QByteArray::number(m_capture->recordCount())
+                + ",\"droppedRecords\":" + QByteArray::number(m_capture->droppedRecords()) + "}";
+    }
+
+    return QByteArray("{\"status\":\"ok\",\"connectedClients\":" + QByteArray::number(connected)
+                      + ",\"protocolVersion\":" + QByteArray::number(ctx.caps.version)
+                      + ",\"maxFrameSize\":" + QByteArray::number(ctx.caps.maxFrameSize)
+                      + ",\"features\":\"" + ctx.caps.describe().toUtf8() + "\""
+                      + ",\"transport\":\"" + (ctx.ring ? "shm" : "socket") + "\""
+                      + ",\"coalescing\":" + (m_coalesce ? "true" : "false")
+                      + ",\"consumerFramesSuperseded\":" + QByteArray::number(m_consumer->framesSuperseded())
+                      + ",\"brightnessChanges\":" + QByteArray::number(m_consumer->brightnessChanges())
+                      + ",\"refreshHz\":" + QByteArray::number(m_consumer->refreshRate())
+                      + ",\"presentation\":" + m_consumer->presentationStats().toJson()
+                      + ",\"capture\":" + capture
+                      + ",\"client\":" + QByteArray::number(ctx.id)
+                      + ",\"worker\":" + QByteArray::number(m_index)
+                      + ",\"workers\":[" + workers + "]"
+                      + ",\"lampArrays\":" + m_consumer->lamps().toJson()
+                      + ",\"clients\":[" + clients + "]}");
+}
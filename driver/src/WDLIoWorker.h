@@ -0,0 +1,149 @@
+#ifndef WDL_IO_WORKER_H
+#define WDL_IO_WORKER_H
+
+#include <QObject>
+#include <QLocalSocket>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QHash>
+#include <QByteArray>
+#include <QVector>
+#include <QTimer>
+
+#include <atomic>
+
+#include "WDLFrameConsumer.h"
+#include "DriverMetrics.h"
+#include "CaptureWriter.h"
+#include "../common/DriverProtocol.h"
+#include "../common/DriverFramer.h"
+#include "../common/FrameDelta.h"
+#include "../common/DeviceFrame.h"
+#include "../common/SharedFrameRing.h"
+#include "../common/Handshake.h"
+#include "../common/MessageSchema.h"
+#include "../common/DriverStats.h"
+#include "../common/FrameTiming.h"
+
+// Carga de um worker. Escrita pelo próprio worker (exceto clients, que o
+// servidor incrementa ao atribuir uma conexão) e lida por qualquer thread.
+struct WorkerLoad {
+    std::atomic<int> clients { 0 };
+    std::atomic<quint64> bytesIn { 0 };
+    std::atomic<quint64> messages { 0 };
+    std::atomic<quint64> busyNs { 0 };     // tempo gasto lendo e processando
+    std::atomic<quint64> queueDrops { 0 }; // frames descartados com a fila cheia
+    std::atomic<quint64> framesSuperseded { 0 }; // frames substituídos por um mais novo no mesmo lote
+    std::atomic<quint64> controlDeferred { 0 }; // controle adiado com a fila cheia (reenviado depois)
+};
+
+// Worker de I/O: vive em uma QThread própria e é dono dos sockets a ele
+// atribuídos. Faz leitura, framing, handshake e as respostas de controle no
+// próprio thread; frames de LED são materializados (deltas aplicados) e
+// entregues ao WDLFrameConsumer pela fila SPSC deste worker.
+class WDLIoWorker : public QObject
+{
+    Q_OBJECT
+public:
+    WDLIoWorker(int index, WDLFrameConsumer* consumer, DriverMetrics::MetricsRegistry* registry, QObject* parent = nullptr);
+    ~WDLIoWorker();
+
+    int index() const { return m_index; }
+    WorkerLoad& load() { return m_load; }
+    const WorkerLoad& load() const { return m_load; }
+
+    // Todos os workers do servidor, para o GetStatus. Definido antes de
+    // iniciar as threads e não muda depois.
+    void setPeers(const QVector<WDLIoWorker*>& peers) { m_peers = peers; }
+
+    // Latest-frame-wins por conexão: de um lote lido do socket só o último
+    // frame de LED segue para o consumidor. Definido antes de iniciar.
+    void setCoalescing(bool enabled) { m_coalesce = enabled; }
+
+    // Gravação das mensagens recebidas (nullptr = desligada)
+    void setCapture(CaptureWriter* capture) { m_capture = capture; }
+
+    // Executados na thread do worker (QMetaObject::invokeMethod)
+    void addClient(quintptr socketDescriptor, quint64 clientId);
+    void shutdown();
+
+signals:
+    void clientConnected(quint64 clientId);
+    void clientDisconnected(quint64 clientId);
+
+private slots:
+    void onReadyRead();
+    void onSocketError(QLocalSocket::LocalSocketError);
+    void onDisconnected();
+
+private:
+    struct ClientCtx {
+        quint64 id = 0;
+        QPointer<QLocalSocket> socket;
+        DriverProtocol::Framer framer; // arena reutilizável para framing
+        DriverProtocol::Capabilities caps; // negociadas no Hello (padrão: legado v0)
+        bool helloReceived = false;
+        QByteArray referenceFrame;     // último frame completo (base dos deltas)
+        QVector<DriverProtocol::DeviceFrameEntry> layout; // tabela device/zona do último SetDeviceFrame
+        QSharedPointer<DriverProtocol::SharedFrameRing> ring; // transporte por memória compartilhada
+        QByteArray ringScratch;        // cópia do slot lido do anel (reutilizada)
+        quint64 deltasApplied = 0;
+        bool keyframeRequested = false; // RequestKeyframe enviado, aguardando SetLedColors/SetDeviceFrame
+        bool framePending = false;     // referenceFrame ainda não entregue (coalescência)
+        bool inEnvelope = false;       // decodificando o frame interno de um TimedFrame
+        bool timedFrameWarned = false; // TimedFrame malformado já registrado no log
+        qint64 presentAtNs = 0;        // horário do TimedFrame em decodificação (0 = sem horário)
+        QSharedPointer<DriverMetrics::ClientMetrics> metrics;
+    };
+
+    int m_index;
+    WDLFrameConsumer* m_consumer;
+    ConsumerQueue& m_queue;
+    DriverMetrics::MetricsRegistry* m_registry;
+    WorkerLoad m_load;
+    QVector<WDLIoWorker*> m_peers;
+    bool m_coalesce = true;
+    CaptureWriter* m_capture = nullptr;
+    QHash<QLocalSocket*, ClientCtx> m_clients;
+    QByteArray m_txScratch; // respostas empacotadas sem alocação por mensagem
+    qint64 m_batchNs = 0;   // instante da leitura em processamento
+
+    // Empacota uma mensagem de schema fixo em m_txScratch e envia
+    template <typename Schema, typename... Args>
+    void reply(QLocalSocket* sock, Args... args)
+    {
+        m_txScratch.resize(0);
+        Schema::packInto(m_txScratch, args...);
+        if (sock) sock->write(m_txScratch);
+    }
+
+    void handleMessage(ClientCtx& ctx, DriverProtocol::MessageType type, const DriverProtocol::PayloadView& payload);
+
+    // Frame materializado em referenceFrame: entrega imediata ou, com
+    // coalescência, adiada até o fim do lote. Frames com horário futuro
+    // são sempre entregues na hora, cada um com o seu presentAtNs.
+    void submitFrame(ClientCtx& ctx);
+
+    // Entrega ao consumidor. Frames são descartados com a fila cheia (o
+    // próximo frame traz o estado completo); controle nunca se perde: sem
+    // espaço, fica em m_controlOverflow e é reenviado no próximo lote ou
+    // pelo m_controlRetry, sem segurar a leitura dos outros clientes.
+    // Enquanto houver controle à espera, frames não passam à frente dele.
+    void pushFrame(const ClientCtx& ctx);
+    void pushControl(ConsumerItem::Kind kind, quint64 clientId, float brightness = 1.0f);
+    bool flushControl(); // true se não sobrou controle à espera
+
+    struct PendingControl {
+        ConsumerItem::Kind kind;
+        quint64 clientId;
+        float brightness;
+        qint64 receivedNs;
+    };
+    static constexpr int ControlRetryMs = 1;
+    QVector<PendingControl> m_controlOverflow; // em ordem de chegada
+    QTimer* m_controlRetry = nullptr;
+
+    QByteArray statusJson(const ClientCtx& ctx) const;
+};
+
+#endif // WDL_IO_WORKER_H
@@ -18,11 +18,22 @@ int main(int argc, char *argv[])
 
     QCommandLineOption nameOpt({"n", "name"}, "Nome do servidor QLocalServer", "name", "OpenRGB_WDL_Driver");
     parser.addOption(nameOpt);
+    QCommandLineOption workersOpt({"w", "workers"}, "Threads de I/O (0 = automático)", "count", "0");
+    parser.addOption(workersOpt);
+    QCommandLineOption noCoalesceOpt("no-coalesce", "Aplica todos os frames em ordem (sem latest-frame-wins)");
+    parser.addOption(noCoalesceOpt);
+    QCommandLineOption refreshOpt({"f", "refresh-hz"}, "Taxa de apresentação cadenciada (0 = aplica ao chegar)", "hz", "0");
+    parser.addOption(refreshOpt);
+    QCommandLineOption recordOpt({"r", "record"}, "Grava as mensagens recebidas em um arquivo de captura", "file");
+    parser.addOption(recordOpt);
     parser.process(app);
 
     const QString serverName = parser.value(nameOpt);
 
-    WDLDriverServer server(serverName);
+    WDLDriverServer server(serverName, parser.value(workersOpt).toInt());
+    server.setCoalescing(!parser.isSet(noCoalesceOpt));
+    server.setRefreshRate(parser.value(refreshOpt).toInt());
+    server.setCaptureFile(parser.value(recordOpt));
     if (!server.start()) {
         QTextStream(stderr) << "Falha ao iniciar o servidor em '" << serverName << "'\n";
         return 1;
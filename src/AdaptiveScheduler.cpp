@@ -0,0 +1,65 @@
+#include "AdaptiveScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+AdaptiveScheduler::AdaptiveScheduler(double deadlineFraction)
+    : m_deadlineFraction(deadlineFraction)
+{
+}
+
+void AdaptiveScheduler::recordTick(qint64 costNs, bool pressured)
+{
+    m_tickCostNs = m_tickCostNs <= 0.0 ? costNs : m_tickCostNs + CostSmoothing * (costNs - m_tickCostNs);
+
+    if (pressured)
+    {
+        m_backoff = std::min(MaxBackoff, m_backoff * 1.5);
+        m_cleanTicks = 0;
+    }
+    else if (m_backoff > 1.0 && ++m_cleanTicks >= CleanTicksToRecover)
+    {
+        m_backoff = std::max(1.0, m_backoff * 0.9);
+    }
+    update();
+}
+
+void AdaptiveScheduler::recordBusCost(qint64 costNs, const QString& bus)
+{
+    m_busCostNs = costNs;
+    m_bus = bus;
+}
+
+int AdaptiveScheduler::sustainableMs() const
+{
+    const double cpuMs = m_tickCostNs / 1e6 / CpuBudget;
+    const double busMs = m_busCostNs / 1e6 / m_deadlineFraction;
+    return std::min(CeilingMs, static_cast<int>(std::ceil(std::max(cpuMs, busMs) * m_backoff)));
+}
+
+void AdaptiveScheduler::update()
+{
+    const double cpuMs = m_tickCostNs / 1e6 / CpuBudget;
+    const double busMs = m_busCostNs / 1e6 / m_deadlineFraction;
+    const double base = std::max(cpuMs, busMs);
+    const int target = qBound(FloorMs, static_cast<int>(std::ceil(base * m_backoff)), CeilingMs);
+
+    // Desacelera na hora; acelera só com folga de 10% (sem oscilar a cada tick)
+    if (target > m_intervalMs || target < m_intervalMs * 0.9)
+    {
+        m_intervalMs = target;
+    }
+
+    if (m_intervalMs <= FloorMs)
+    {
+        m_limit = Limit::Floor;
+    }
+    else if (m_backoff > 1.0 && base < m_intervalMs)
+    {
+        m_limit = Limit::Backoff;
+    }
+    else
+    {
+        m_limit = busMs > cpuMs ? Limit::Device : Limit::Cpu;
+    }
+}
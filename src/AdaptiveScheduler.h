@@ -0,0 +1,60 @@
+#ifndef ADAPTIVE_SCHEDULER_H
+#define ADAPTIVE_SCHEDULER_H
+
+#include <QString>
+#include <QtGlobal>
+
+// Escolhe o espaçamento entre ticks a partir do custo medido: o menor
+// intervalo que cabe no orçamento de CPU da thread de sincronização e que
+// dá tempo ao barramento mais lento de terminar dentro do prazo do tick.
+// Ticks com atraso (prazo estourado ou dispositivo ainda ocupado) aumentam
+// um fator de recuo, que volta aos poucos depois de ticks limpos.
+class AdaptiveScheduler
+{
+public:
+    enum class Limit
+    {
+        Floor,   // custo baixo: taxa máxima
+        Cpu,     // custo do tick na thread de sincronização
+        Device,  // barramento mais lento (soma dos seus dispositivos)
+        Backoff  // atrasos recentes
+    };
+
+    static constexpr int    FloorMs = 8;       // ~120 Hz
+    static constexpr int    CeilingMs = 1000;
+    static constexpr double CpuBudget = 0.25;  // fração de um núcleo
+    static constexpr double MaxBackoff = 8.0;
+
+    explicit AdaptiveScheduler(double deadlineFraction);
+
+    // Custo de um tick na thread do worker (sem a espera pelos dispositivos)
+    // e se ele terminou com atraso
+    void recordTick(qint64 costNs, bool pressured);
+    // Soma dos custos por dispositivo do barramento mais caro
+    void recordBusCost(qint64 costNs, const QString& bus);
+
+    int intervalMs() const { return m_intervalMs; }
+    int sustainableMs() const; // sem o piso; para as transições
+    Limit limit() const { return m_limit; }
+    QString limitingBus() const { return m_bus; }
+    qint64 tickCostNs() const { return static_cast<qint64>(m_tickCostNs); }
+    qint64 busCostNs() const { return m_busCostNs; }
+    double backoff() const { return m_backoff; }
+
+private:
+    double  m_deadlineFraction;
+    double  m_tickCostNs = 0.0; // média móvel exponencial
+    qint64  m_busCostNs = 0;
+    QString m_bus;
+    double  m_backoff = 1.0;
+    int     m_cleanTicks = 0;
+    int     m_intervalMs = FloorMs;
+    Limit   m_limit = Limit::Floor;
+
+    static constexpr double CostSmoothing = 0.2;
+    static constexpr int    CleanTicksToRecover = 10;
+
+    void update();
+};
+
+#endif // ADAPTIVE_SCHEDULER_H
@@ -0,0 +1,50 @@
+#include "ColorCalibration.h"
+#include "RGBController.h"
+
+#include <algorithm>
+#include <cmath>
+
+CalibrationProfile CalibrationProfile::match(const QVector<CalibrationProfile>& profiles, const RGBController* ctrl)
+{
+    const QString name = QString::fromStdString(ctrl->name);
+    const QString location = QString::fromStdString(ctrl->location);
+
+    const CalibrationProfile* fallback = nullptr;
+    for (const CalibrationProfile& p : profiles)
+    {
+        if (p.device.isEmpty())
+        {
+            if (!fallback) fallback = &p;
+            continue;
+        }
+        if (p.device == name && (p.location.isEmpty() || p.location == location))
+        {
+            return p;
+        }
+    }
+    return fallback ? *fallback : CalibrationProfile();
+}
+
+ColorLut ColorLut::compile(const CalibrationProfile& profile, double brightness)
+{
+    const double gamma = profile.gamma > 0.0 ? profile.gamma : 1.0;
+    const double level = std::clamp(brightness, 0.0, 1.0);
+    const double scale[3] = {
+        level * std::max(0.0, profile.gain[0]) * profile.white.red()   / 255.0,
+        level * std::max(0.0, profile.gain[1]) * profile.white.green() / 255.0,
+        level * std::max(0.0, profile.gain[2]) * profile.white.blue()  / 255.0,
+    };
+
+    ColorLut lut;
+    quint8* tables[3] = { lut.red, lut.green, lut.blue };
+    for (int v = 0; v < 256; ++v)
+    {
+        const double x = v / 255.0;
+        const double linear = gamma == 1.0 ? x : std::pow(x, gamma);
+        for (int c = 0; c < 3; ++c)
+        {
+            tables[c][v] = static_cast<quint8>(qBound(0, qRound(linear * scale[c] * 255.0), 255));
+        }
+    }
+    return lut;
+}
@@ -0,0 +1,36 @@
+#ifndef COLOR_CALIBRATION_H
+#define COLOR_CALIBRATION_H
+
+#include <QColor>
+#include <QString>
+#include <QVector>
+
+class RGBController;
+
+// Ajuste de cor de um dispositivo (ou o padrão, com device vazio): cada
+// marca tem outra curva de PWM e outro branco para a mesma cor de entrada.
+struct CalibrationProfile
+{
+    QString device;   // nome do controlador; vazio = padrão
+    QString location; // vazio = qualquer local com esse nome
+    double  gamma = 1.0;                  // entrada^gamma (1.0 = linear, como antes)
+    double  gain[3] = { 1.0, 1.0, 1.0 };  // por canal, 0.0 - 1.0+
+    QColor  white { 255, 255, 255 };      // o que o dispositivo recebe para branco neutro
+
+    // Perfil do controlador: o específico, senão o padrão, senão identidade
+    static CalibrationProfile match(const QVector<CalibrationProfile>& profiles, const RGBController* ctrl);
+};
+
+// Tabela por canal com gamma, ganho, balanço de branco e brilho já
+// aplicados: o frame de saída é só uma consulta por byte, sem ponto
+// flutuante por LED. Recompilada quando o perfil ou o brilho mudam.
+struct ColorLut
+{
+    quint8 red[256];
+    quint8 green[256];
+    quint8 blue[256];
+
+    static ColorLut compile(const CalibrationProfile& profile, double brightness);
+};
+
+#endif // COLOR_CALIBRATION_H
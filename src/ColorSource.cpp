@@ -0,0 +1,83 @@
+#include "ColorSource.h"
+#include "RegistryColorSource.h"
+#include "StreamColorSource.h"
+
+#include <QRegularExpression>
+#include <QStringList>
+
+ColorSource* ColorSource::create(const QString& spec, QObject* parent)
+{
+    const QString s = spec.trimmed();
+    if (s.isEmpty() || s == "registry")
+    {
+#ifdef Q_OS_WIN
+        return new RegistryColorSource(parent);
+#else
+        return nullptr;
+#endif
+    }
+    if (s.startsWith("file:"))
+    {
+        return new FileColorSource(s.mid(5), parent);
+    }
+    if (s == "stdin")
+    {
+        return new StdinColorSource(parent);
+    }
+    if (s.startsWith("socket:"))
+    {
+        return new SocketColorSource(s.mid(7), parent);
+    }
+    return nullptr;
+}
+
+bool ColorSource::parseColor(const QString& text, QColor& color)
+{
+    const QString s = text.trimmed();
+    if (s.isEmpty())
+    {
+        return false;
+    }
+
+    // "r g b" / "r,g,b"
+    const QStringList parts = s.split(QRegularExpression("[\\s,;]+"), Qt::SkipEmptyParts);
+    if (parts.size() == 3)
+    {
+        int rgb[3];
+        bool ok = true;
+        for (int i = 0; i < 3 && ok; ++i)
+        {
+            rgb[i] = parts.at(i).toInt(&ok);
+            ok = ok && rgb[i] >= 0 && rgb[i] <= 255;
+        }
+        if (ok)
+        {
+            color = QColor(rgb[0], rgb[1], rgb[2]);
+            return true;
+        }
+    }
+
+    // "#RRGGBB" / nome SVG; "RRGGBB" sem '#' também (isValidColor evita o
+    // aviso do QColor para nomes desconhecidos)
+    if (QColor::isValidColor(s))
+    {
+        color = QColor(s);
+        return true;
+    }
+    if (!s.startsWith('#') && QColor::isValidColor("#" + s))
+    {
+        color = QColor("#" + s);
+        return true;
+    }
+    return false;
+}
+
+void ColorSource::updateColor(const QColor& color)
+{
+    if (color == m_color)
+    {
+        return;
+    }
+    m_color = color;
+    emit colorChanged(m_color);
+}
@@ -0,0 +1,52 @@
+#ifndef COLOR_SOURCE_H
+#define COLOR_SOURCE_H
+
+#include <QObject>
+#include <QColor>
+#include <QString>
+
+// Origem da cor base da sincronização. Implementações avisam mudanças por
+// colorChanged em vez de serem consultadas a cada tick; currentColor()
+// devolve o último valor conhecido (leitura barata, sem I/O).
+//
+// Vive na thread de quem chamou start() (a do WDLSyncWorker), que precisa
+// ter event loop: os avisos chegam por notifiers do Qt.
+class ColorSource : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ColorSource(QObject* parent = nullptr) : QObject(parent) {}
+    ~ColorSource() override = default;
+
+    virtual bool start() = 0;
+    virtual void stop() = 0;
+    virtual QString describe() const = 0;
+
+    // Fontes de teste (arquivo/stdin/socket) não dependem do Dynamic Lighting
+    virtual bool requiresPlatform() const { return true; }
+
+    QColor currentColor() const { return m_color; }
+
+    // Especificação (configuração "colorSource" ou variável WDL_COLOR_SOURCE):
+    //   registry         cor de acentuação do DWM (padrão no Windows)
+    //   file:<caminho>   última linha do arquivo, relida quando ele muda
+    //   stdin            uma cor por linha na entrada padrão
+    //   socket:<nome>    uma cor por linha de clientes do QLocalServer <nome>
+    // Cores: "#RRGGBB", nome SVG ("red"), "r g b" ou "r,g,b".
+    // Retorna nullptr se a fonte não existe nesta plataforma.
+    static ColorSource* create(const QString& spec, QObject* parent = nullptr);
+
+    static bool parseColor(const QString& text, QColor& color);
+
+signals:
+    void colorChanged(const QColor& color);
+
+protected:
+    // Emite colorChanged só quando o valor muda
+    void updateColor(const QColor& color);
+
+private:
+    QColor m_color { 255, 255, 255 }; // fallback branco
+};
+
+#endif // COLOR_SOURCE_H
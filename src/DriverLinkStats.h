@@ -0,0 +1,189 @@
+#ifndef DRIVER_LINK_STATS_H
+#define DRIVER_LINK_STATS_H
+
+#include <QtGlobal>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+
+// Janela deslizante das últimas amostras (ns). Percentis são calculados sob
+// demanda (refresh do status), fora do caminho de envio.
+class RollingWindow
+{
+public:
+    struct Summary
+    {
+        int    count = 0;
+        qint64 p50   = 0;
+        qint64 p99   = 0;
+        qint64 max   = 0;
+    };
+
+    explicit RollingWindow(int capacity = 256) : m_samples(capacity) {}
+
+    void add(qint64 value)
+    {
+        m_samples[m_next] = value;
+        m_next = (m_next + 1) % m_samples.size();
+        if (m_count < m_samples.size())
+        {
+            ++m_count;
+        }
+    }
+
+    int count() const { return m_count; }
+
+    Summary summarize() const
+    {
+        Summary s;
+        s.count = m_count;
+        if (m_count == 0)
+        {
+            return s;
+        }
+
+        // Enquanto a janela não enche as amostras ocupam o início do buffer
+        m_sorted.resize(m_count);
+        std::copy(m_samples.constBegin(), m_samples.constBegin() + m_count, m_sorted.begin());
+        std::sort(m_sorted.begin(), m_sorted.end());
+        s.p50 = m_sorted.at(rank(0.50));
+        s.p99 = m_sorted.at(rank(0.99));
+        s.max = m_sorted.last();
+        return s;
+    }
+
+private:
+    QVector<qint64> m_samples;
+    mutable QVector<qint64> m_sorted;
+    int m_next  = 0;
+    int m_count = 0;
+
+    // Nearest-rank
+    int rank(double p) const
+    {
+        return qBound(0, static_cast<int>(std::ceil(p * m_count)) - 1, m_count - 1);
+    }
+};
+
+// Qualidade do enlace plugin -> driver, no relógio comum dos dois lados
+// (DriverProtocol::presentationClockNs):
+//  - RTT dos Pings com horário;
+//  - latência envio -> recepção de cada frame, pelos FrameAcks;
+//  - perdas e reordenação pela sequência dos acks (um ack abaixo do
+//    esperado chega depois de o frame ter sido dado como perdido).
+// Frames substituídos na fila de envio (DriverSendQueue) consomem uma
+// sequência sem chegar ao driver; o buraco que deixam não é perda.
+class DriverLinkStats
+{
+public:
+    static constexpr int MaxCoalescedTracked = 256;
+
+    // Sequência do próximo frame enviado na conexão
+    quint32 nextSequence()
+    {
+        ++m_framesSent;
+        return m_nextSeq++;
+    }
+
+    // Frame numerado descartado pela fila antes de ir ao socket. Chega
+    // sempre antes do ack do frame que o substituiu (sequência maior).
+    void onFrameCoalesced(quint32 seq)
+    {
+        if (m_framesSent > 0)
+        {
+            --m_framesSent;
+        }
+        if (m_coalesced.size() >= MaxCoalescedTracked)
+        {
+            m_coalesced.removeFirst();
+        }
+        m_coalesced.append(seq);
+    }
+
+    // Nova conexão: o primeiro ack recebido vira a base da sequência (um
+    // frame numerado antes da reconexão pode ser o primeiro a chegar).
+    // Janelas e contadores são da sessão.
+    void resetConnection()
+    {
+        m_synced = false;
+        m_coalesced.clear();
+    }
+
+    void onPong(qint64 sentNs, qint64 nowNs)
+    {
+        if (nowNs >= sentNs)
+        {
+            m_rtt.add(nowNs - sentNs);
+        }
+    }
+
+    void onFrameAck(quint32 seq, qint64 sentNs, qint64 receivedNs)
+    {
+        ++m_framesAcked;
+        if (receivedNs >= sentNs)
+        {
+            m_oneWay.add(receivedNs - sentNs);
+        }
+
+        if (!m_synced)
+        {
+            m_synced = true;
+            m_expected = seq + 1;
+            dropCoalescedBefore(seq);
+            return;
+        }
+
+        const qint32 gap = static_cast<qint32>(seq - m_expected);
+        if (gap >= 0)
+        {
+            // Os descartados antes deste ack estão todos em [m_expected, seq)
+            const quint64 skipped = static_cast<quint64>(dropCoalescedBefore(seq));
+            m_framesLost += static_cast<quint64>(gap) - qMin(static_cast<quint64>(gap), skipped);
+            m_expected = seq + 1;
+        }
+        else
+        {
+            ++m_framesReordered;
+            if (m_framesLost > 0)
+            {
+                --m_framesLost;
+            }
+        }
+    }
+
+    RollingWindow::Summary rtt() const { return m_rtt.summarize(); }
+    RollingWindow::Summary oneWay() const { return m_oneWay.summarize(); }
+    bool hasSamples() const { return m_rtt.count() > 0 || m_oneWay.count() > 0; }
+
+    quint64 framesSent() const { return m_framesSent; }
+    quint64 framesAcked() const { return m_framesAcked; }
+    quint64 framesLost() const { return m_framesLost; }
+    quint64 framesReordered() const { return m_framesReordered; }
+
+private:
+    RollingWindow m_rtt;
+    RollingWindow m_oneWay;
+    quint32 m_nextSeq  = 0;
+    quint32 m_expected = 0;
+    bool    m_synced   = false;
+    quint64 m_framesSent      = 0;
+    quint64 m_framesAcked     = 0;
+    quint64 m_framesLost      = 0;
+    quint64 m_framesReordered = 0;
+    QVector<quint32> m_coalesced; // sequências descartadas ainda sem ack posterior, em ordem
+
+    // Remove (e conta) as sequências descartadas anteriores a seq
+    int dropCoalescedBefore(quint32 seq)
+    {
+        int dropped = 0;
+        while (!m_coalesced.isEmpty() && static_cast<qint32>(m_coalesced.first() - seq) < 0)
+        {
+            m_coalesced.removeFirst();
+            ++dropped;
+        }
+        return dropped;
+    }
+};
+
+#endif // DRIVER_LINK_STATS_H
@@ -0,0 +1,151 @@
+#ifndef DRIVER_SEND_QUEUE_H
+#define DRIVER_SEND_QUEUE_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QIODevice>
+#include <QQueue>
+
+#include <algorithm>
+#include <cstring>
+
+// Fila de saída para o driver, sem esperas bloqueantes. Pacotes só vão ao
+// socket enquanto o buffer dele está abaixo de SocketHighWaterBytes; o
+// restante fica aqui e sai no próximo pump() (sinal bytesWritten).
+//
+// Duas faixas: controle (Hello, brilho, Ping...) é sempre entregue e em
+// ordem; frames de cor guardam só o mais novo, e um frame ainda não
+// iniciado é substituído pelo seguinte. Controle nunca passa à frente de
+// um frame enfileirado antes dele: o frame pendente entra na faixa de
+// controle (deixa de ser substituível) e o brilho chega ao driver entre os
+// frames certos. Quem enfileira precisa mandar frames autocontidos
+// (keyframe, não delta) enquanto framePending().
+class DriverSendQueue
+{
+public:
+    enum class Lane
+    {
+        Control,
+        Frame
+    };
+
+    static constexpr qint64 SocketHighWaterBytes = 64 * 1024;
+    static constexpr qint64 ControlLimitBytes = 1024 * 1024; // driver parado
+    static constexpr qint64 NoSequence = -1;
+
+    // false: faixa de controle acima do limite (conexão deve ser refeita)
+    bool enqueueControl(const QByteArray& packet)
+    {
+        if (m_controlBytes + m_frame.size() + packet.size() > ControlLimitBytes)
+        {
+            return false;
+        }
+        // Frame enviado antes desta mensagem sai antes dela
+        if (!m_frame.isEmpty())
+        {
+            m_controlBytes += m_frame.size();
+            m_control.enqueue(m_frame);
+            m_frame = QByteArray();
+            m_frameSeq = NoSequence;
+        }
+        // Cópia profunda: o buffer de envio do chamador segue sem compartilhar
+        m_control.enqueue(QByteArray(packet.constData(), packet.size()));
+        m_controlBytes += packet.size();
+        notePeak();
+        return true;
+    }
+
+    // seq: sequência do TimedFrame no pacote (NoSequence se não tiver).
+    // Devolve a sequência do frame substituído, ou NoSequence.
+    qint64 enqueueFrame(const QByteArray& packet, qint64 seq = NoSequence)
+    {
+        qint64 replaced = NoSequence;
+        if (!m_frame.isEmpty())
+        {
+            ++m_framesCoalesced;
+            replaced = m_frameSeq;
+        }
+        // Reaproveita a capacidade do frame anterior (sem alocação por tick)
+        m_frame.resize(packet.size());
+        std::memcpy(m_frame.data(), packet.constData(), static_cast<size_t>(packet.size()));
+        m_frameSeq = seq;
+        notePeak();
+        return replaced;
+    }
+
+    bool framePending() const { return !m_frame.isEmpty(); }
+
+    // Entrega ao dispositivo até o limite do buffer dele; false se write falhou
+    bool pump(QIODevice* device)
+    {
+        while (device->bytesToWrite() < SocketHighWaterBytes)
+        {
+            if (m_offset >= m_current.size())
+            {
+                if (!m_control.isEmpty())
+                {
+                    m_current = m_control.dequeue();
+                    m_controlBytes -= m_current.size();
+                }
+                else if (!m_frame.isEmpty())
+                {
+                    m_current.swap(m_frame);
+                    m_frame.resize(0);
+                    m_frameSeq = NoSequence;
+                }
+                else
+                {
+                    m_current.resize(0);
+                    m_offset = 0;
+                    break;
+                }
+                m_offset = 0;
+            }
+
+            const qint64 written = device->write(m_current.constData() + m_offset, m_current.size() - m_offset);
+            if (written < 0)
+            {
+                return false;
+            }
+            if (written == 0)
+            {
+                break;
+            }
+            m_offset += static_cast<int>(written);
+        }
+        return true;
+    }
+
+    // Conexão perdida: nada do que estava pendente vale para a próxima
+    void clear()
+    {
+        m_control.clear();
+        m_controlBytes = 0;
+        m_frame.resize(0);
+        m_frameSeq = NoSequence;
+        m_current.resize(0);
+        m_offset = 0;
+    }
+
+    int depth() const
+    {
+        return m_control.size() + (m_frame.isEmpty() ? 0 : 1) + (m_offset < m_current.size() ? 1 : 0);
+    }
+    qint64 queuedBytes() const { return m_controlBytes + m_frame.size() + (m_current.size() - m_offset); }
+    int peakDepth() const { return m_peakDepth; }
+    quint64 framesCoalesced() const { return m_framesCoalesced; }
+
+private:
+    QQueue<QByteArray> m_control;
+    qint64     m_controlBytes = 0;
+    QByteArray m_frame;   // frame mais novo ainda não iniciado
+    qint64     m_frameSeq = NoSequence;
+    QByteArray m_current; // pacote em escrita (write parcial continua daqui)
+    int        m_offset = 0;
+    int        m_peakDepth = 0;
+    quint64    m_framesCoalesced = 0;
+
+    void notePeak() { m_peakDepth = std::max(m_peakDepth, depth()); }
+};
+
+#endif // DRIVER_SEND_QUEUE_H
@@ -0,0 +1,140 @@
+#include "EffectEngine.h"
+#include "EffectKernels.h"
+#include "LedSpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // fract() para um valor qualquer, em [0, 1)
+    float wrap(double x)
+    {
+        return static_cast<float>(x - std::floor(x));
+    }
+
+    void channels(const QColor& color, float out[3])
+    {
+        out[0] = static_cast<float>(color.red());
+        out[1] = static_cast<float>(color.green());
+        out[2] = static_cast<float>(color.blue());
+    }
+}
+
+bool EffectEngine::isAnimated(EffectType type)
+{
+    return type != EffectType::Static && type != EffectType::Gradient;
+}
+
+bool EffectEngine::usesDirection(EffectType type)
+{
+    return type == EffectType::Wave || type == EffectType::Rainbow
+        || type == EffectType::Wheel || type == EffectType::Gradient;
+}
+
+bool EffectEngine::usesSecondary(EffectType type)
+{
+    return type == EffectType::Breathing || type == EffectType::Wave || type == EffectType::Gradient;
+}
+
+void EffectEngine::resizePlanes(int count, int planeSize)
+{
+    // Planos com o excedente zerado: os kernels processam a capacidade toda
+    m_count = count;
+    m_axis.fill(0.0f, planeSize);
+    m_value.fill(0.0f, planeSize);
+    m_red.fill(0.0f, planeSize);
+    m_green.fill(0.0f, planeSize);
+    m_blue.fill(0.0f, planeSize);
+}
+
+void EffectEngine::render(const EffectParams& params, double timeSec, const LedSpatialIndex& index, char* rgbOut)
+{
+    if (index.ledCount() != m_count || index.planeSize() != m_axis.size())
+    {
+        resizePlanes(index.ledCount(), index.planeSize());
+    }
+
+    const int n = m_axis.size();
+    const float* axis = index.projection(params.direction);
+    const float scale = static_cast<float>(std::max(0.0, params.scale));
+    // Fase decrescente no tempo: o padrão anda no sentido crescente do eixo
+    const float travel = wrap(-timeSec * params.speed);
+
+    // Brilho não entra aqui: fica nas LUTs de cada dispositivo
+    float primary[3];
+    float secondary[3];
+    channels(params.primary, primary);
+    channels(params.secondary, secondary);
+
+    switch (params.type)
+    {
+        case EffectType::Breathing:
+        {
+            // Uniforme: uma intensidade por frame, secundária -> primária
+            const float x = wrap(timeSec * params.speed);
+            const float d = std::fabs(2.0f * x - 1.0f);
+            const float t = 1.0f - d;
+            const float w = t * t * (3.0f - 2.0f * t);
+            fill(qRound(secondary[0] + (primary[0] - secondary[0]) * w),
+                 qRound(secondary[1] + (primary[1] - secondary[1]) * w),
+                 qRound(secondary[2] + (primary[2] - secondary[2]) * w), rgbOut);
+            return;
+        }
+        case EffectType::Wave:
+            EffectKernels::phase(axis, n, scale, travel, m_value.data());
+            EffectKernels::pulse(m_value.constData(), n, m_value.data());
+            EffectKernels::mix(m_value.constData(), n, secondary, primary, m_red.data(), m_green.data(), m_blue.data());
+            break;
+        case EffectType::Rainbow:
+            EffectKernels::phase(axis, n, scale, travel, m_value.data());
+            EffectKernels::hueToRgb(m_value.constData(), n, 255.0f,
+                                    m_red.data(), m_green.data(), m_blue.data());
+            break;
+        case EffectType::Wheel:
+        {
+            // Matiz pelo ângulo em volta do centro, girando no tempo
+            const bool counter = params.direction == EffectDirection::Reverse || params.direction == EffectDirection::Inward;
+            const float* angle = index.angle();
+            if (counter)
+            {
+                EffectKernels::reverse(index.angle(), n, m_axis.data());
+                angle = m_axis.constData();
+            }
+            EffectKernels::phase(angle, n, 1.0f, travel, m_value.data());
+            EffectKernels::hueToRgb(m_value.constData(), n, 255.0f,
+                                    m_red.data(), m_green.data(), m_blue.data());
+            break;
+        }
+        case EffectType::Gradient:
+            // Estático: primária no início do eixo, secundária no fim
+            EffectKernels::mix(axis, n, primary, secondary,
+                               m_red.data(), m_green.data(), m_blue.data());
+            break;
+        case EffectType::Static:
+        default:
+            fill(qRound(primary[0]), qRound(primary[1]), qRound(primary[2]), rgbOut);
+            return;
+    }
+
+    pack(rgbOut);
+}
+
+void EffectEngine::fill(int r, int g, int b, char* rgbOut) const
+{
+    const char cr = static_cast<char>(qBound(0, r, 255));
+    const char cg = static_cast<char>(qBound(0, g, 255));
+    const char cb = static_cast<char>(qBound(0, b, 255));
+    for (int i = 0; i < m_count; ++i)
+    {
+        *rgbOut++ = cr;
+        *rgbOut++ = cg;
+        *rgbOut++ = cb;
+    }
+}
+
+void EffectEngine::pack(char* rgbOut) const
+{
+    EffectKernels::packRgb(m_red.constData(), m_green.constData(), m_blue.constData(), m_count,
+                           reinterpret_cast<uchar*>(rgbOut));
+}
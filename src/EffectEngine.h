@@ -0,0 +1,72 @@
+#ifndef EFFECT_ENGINE_H
+#define EFFECT_ENGINE_H
+
+#include <QColor>
+#include <QVector>
+
+// Efeitos do Dynamic Lighting (Configurações > Personalização > Iluminação)
+enum class EffectType
+{
+    Static,
+    Breathing,
+    Rainbow,
+    Wave,
+    Wheel,
+    Gradient
+};
+
+// Sentido do efeito no canvas dos LEDs (LedSpatialIndex)
+enum class EffectDirection
+{
+    Forward, // esquerda -> direita
+    Reverse, // direita -> esquerda
+    Outward, // centro -> bordas
+    Inward,  // bordas -> centro
+    Up,      // baixo -> cima
+    Down     // cima -> baixo
+};
+constexpr int EffectDirectionCount = 6;
+
+class LedSpatialIndex;
+
+struct EffectParams
+{
+    EffectType      type = EffectType::Static;
+    EffectDirection direction = EffectDirection::Forward;
+    QColor primary   { 255, 255, 255 };
+    QColor secondary { 0, 0, 0 };
+    double speed = 0.5; // ciclos por segundo
+    double scale = 1.0; // repetições ao longo do eixo (onda, arco-íris)
+};
+
+// Renderiza um efeito em um frame RGB888 com um valor por LED, na ordem do
+// LedSpatialIndex. As coordenadas vêm das tabelas projetadas do índice
+// (posição na direção do efeito em [0, 1], ângulo da roda em [0, 1)); os
+// cálculos correm sobre planos float com os kernels de EffectKernels.h e
+// só no fim viram bytes.
+class EffectEngine
+{
+public:
+    static bool isAnimated(EffectType type);
+    static bool usesDirection(EffectType type);
+    static bool usesSecondary(EffectType type);
+
+    // rgbOut: index.ledCount() * 3 bytes
+    void render(const EffectParams& params, double timeSec, const LedSpatialIndex& index, char* rgbOut);
+
+private:
+    int m_count = 0;
+
+    // Planos de trabalho, com a capacidade dos planos do índice
+    QVector<float> m_axis;
+    QVector<float> m_value;
+    QVector<float> m_red;
+    QVector<float> m_green;
+    QVector<float> m_blue;
+
+    void resizePlanes(int count, int planeSize);
+    void fill(int r, int g, int b, char* rgbOut) const;
+    void pack(char* rgbOut) const;
+};
+
+#endif // EFFECT_ENGINE_H
@@ -0,0 +1,217 @@
+#ifndef EFFECT_KERNELS_H
+#define EFFECT_KERNELS_H
+
+#include <QtGlobal>
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WDL_EFFECT_SSE2 1
+#endif
+
+// Kernels dos efeitos sobre planos float (structure-of-arrays), um valor
+// por LED. Os planos têm capacidade múltipla de PlaneBlock com o excedente
+// zerado, então os laços vetoriais não precisam de tratamento de cauda.
+// Coordenadas e fases ficam em [0, 1]; cores em [0, 255].
+namespace EffectKernels {
+
+constexpr int PlaneBlock = 16;
+
+inline int paddedCount(int n)
+{
+    return (n + PlaneBlock - 1) & ~(PlaneBlock - 1);
+}
+
+// out = 1 - x (sentido inverso)
+inline void reverse(const float* x, int n, float* out)
+{
+#ifdef WDL_EFFECT_SSE2
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (int i = 0; i < n; i += 4) {
+        _mm_storeu_ps(out + i, _mm_sub_ps(one, _mm_loadu_ps(x + i)));
+    }
+#else
+    for (int i = 0; i < n; ++i) out[i] = 1.0f - x[i];
+#endif
+}
+
+// out = fract(x * scale + offset). x >= 0, scale >= 0 e offset em [0, 1):
+// o argumento nunca é negativo e o truncamento vale como floor.
+inline void phase(const float* x, int n, float scale, float offset, float* out)
+{
+#ifdef WDL_EFFECT_SSE2
+    const __m128 s = _mm_set1_ps(scale);
+    const __m128 o = _mm_set1_ps(offset);
+    for (int i = 0; i < n; i += 4) {
+        const __m128 v = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(x + i), s), o);
+        _mm_storeu_ps(out + i, _mm_sub_ps(v, _mm_cvtepi32_ps(_mm_cvttps_epi32(v))));
+    }
+#else
+    for (int i = 0; i < n; ++i) {
+        const float v = x[i] * scale + offset;
+        out[i] = v - static_cast<float>(static_cast<int>(v));
+    }
+#endif
+}
+
+// Pulso suave 0 -> 1 -> 0 ao longo da fase: triângulo t = 1 - |2x - 1|
+// passado por smoothstep (t²(3 - 2t)), próximo de 0.5 - 0.5cos(2πx)
+inline void pulse(const float* x, int n, float* out)
+{
+#ifdef WDL_EFFECT_SSE2
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 three = _mm_set1_ps(3.0f);
+    for (int i = 0; i < n; i += 4) {
+        const __m128 d = _mm_and_ps(_mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(x + i), two), one), absMask);
+        const __m128 t = _mm_sub_ps(one, d);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(three, _mm_mul_ps(two, t))));
+    }
+#else
+    for (int i = 0; i < n; ++i) {
+        float d = 2.0f * x[i] - 1.0f;
+        d = d < 0.0f ? -d : d;
+        const float t = 1.0f - d;
+        out[i] = t * t * (3.0f - 2.0f * t);
+    }
+#endif
+}
+
+// Planos de cor = a + (b - a) * w
+inline void mix(const float* w, int n, const float a[3], const float b[3], float* r, float* g, float* bl)
+{
+#ifdef WDL_EFFECT_SSE2
+    const __m128 ar = _mm_set1_ps(a[0]), dr = _mm_set1_ps(b[0] - a[0]);
+    const __m128 ag = _mm_set1_ps(a[1]), dg = _mm_set1_ps(b[1] - a[1]);
+    const __m128 ab = _mm_set1_ps(a[2]), db = _mm_set1_ps(b[2] - a[2]);
+    for (int i = 0; i < n; i += 4) {
+        const __m128 v = _mm_loadu_ps(w + i);
+        _mm_storeu_ps(r + i,  _mm_add_ps(ar, _mm_mul_ps(dr, v)));
+        _mm_storeu_ps(g + i,  _mm_add_ps(ag, _mm_mul_ps(dg, v)));
+        _mm_storeu_ps(bl + i, _mm_add_ps(ab, _mm_mul_ps(db, v)));
+    }
+#else
+    for (int i = 0; i < n; ++i) {
+        r[i]  = a[0] + (b[0] - a[0]) * w[i];
+        g[i]  = a[1] + (b[1] - a[1]) * w[i];
+        bl[i] = a[2] + (b[2] - a[2]) * w[i];
+    }
+#endif
+}
+
+// Matiz em [0, 1) -> RGB saturado com valor 'level' (0..255), sem desvios:
+// r = sat(|6h - 3| - 1), g = sat(2 - |6h - 2|), b = sat(2 - |6h - 4|)
+inline void hueToRgb(const float* h, int n, float level, float* r, float* g, float* b)
+{
+#ifdef WDL_EFFECT_SSE2
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 three = _mm_set1_ps(3.0f);
+    const __m128 four = _mm_set1_ps(4.0f);
+    const __m128 six = _mm_set1_ps(6.0f);
+    const __m128 lvl = _mm_set1_ps(level);
+    for (int i = 0; i < n; i += 4) {
+        const __m128 h6 = _mm_mul_ps(_mm_loadu_ps(h + i), six);
+        const __m128 vr = _mm_sub_ps(_mm_and_ps(_mm_sub_ps(h6, three), absMask), one);
+        const __m128 vg = _mm_sub_ps(two, _mm_and_ps(_mm_sub_ps(h6, two), absMask));
+        const __m128 vb = _mm_sub_ps(two, _mm_and_ps(_mm_sub_ps(h6, four), absMask));
+        _mm_storeu_ps(r + i, _mm_mul_ps(_mm_min_ps(_mm_max_ps(vr, zero), one), lvl));
+        _mm_storeu_ps(g + i, _mm_mul_ps(_mm_min_ps(_mm_max_ps(vg, zero), one), lvl));
+        _mm_storeu_ps(b + i, _mm_mul_ps(_mm_min_ps(_mm_max_ps(vb, zero), one), lvl));
+    }
+#else
+    const auto sat = [](float v) { return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v); };
+    const auto absf = [](float v) { return v < 0.0f ? -v : v; };
+    for (int i = 0; i < n; ++i) {
+        const float h6 = h[i] * 6.0f;
+        r[i] = sat(absf(h6 - 3.0f) - 1.0f) * level;
+        g[i] = sat(2.0f - absf(h6 - 2.0f)) * level;
+        b[i] = sat(2.0f - absf(h6 - 4.0f)) * level;
+    }
+#endif
+}
+
+// Um canal float -> byte, saturado e arredondado para o par mais próximo:
+// mesma regra de _mm_cvtps_epi32 (modo padrão), então o corpo vetorial, a
+// sobra n % 4 e builds sem SSE2 dão o mesmo byte para o mesmo valor.
+inline uchar quantizeChannel(float v)
+{
+    return static_cast<uchar>(v <= 0.0f ? 0 : (v >= 255.0f ? 255 : static_cast<int>(std::nearbyint(v))));
+}
+
+// Planos float -> RGB888 intercalado (arredondado e saturado). A conversão
+// é vetorial; o entrelaçamento fica num laço simples sobre bytes.
+inline void packRgb(const float* r, const float* g, const float* b, int n, uchar* out)
+{
+#ifdef WDL_EFFECT_SSE2
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 max = _mm_set1_ps(255.0f);
+    alignas(16) quint8 lanes[3][16];
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const float* planes[3] = { r + i, g + i, b + i };
+        for (int c = 0; c < 3; ++c) {
+            __m128i q[4];
+            for (int k = 0; k < 4; ++k) {
+                const __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(planes[c] + 4 * k), zero), max);
+                q[k] = _mm_cvtps_epi32(v); // arredonda para o par mais próximo
+            }
+            const __m128i lo = _mm_packs_epi32(q[0], q[1]);
+            const __m128i hi = _mm_packs_epi32(q[2], q[3]);
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes[c]), _mm_packus_epi16(lo, hi));
+        }
+        uchar* dst = out + 3 * i;
+        for (int k = 0; k < 16; ++k) {
+            dst[3 * k]     = lanes[0][k];
+            dst[3 * k + 1] = lanes[1][k];
+            dst[3 * k + 2] = lanes[2][k];
+        }
+    }
+    for (; i < n; ++i) {
+        out[3 * i]     = quantizeChannel(r[i]);
+        out[3 * i + 1] = quantizeChannel(g[i]);
+        out[3 * i + 2] = quantizeChannel(b[i]);
+    }
+#else
+    for (int i = 0; i < n; ++i) {
+        out[3 * i]     = quantizeChannel(r[i]);
+        out[3 * i + 1] = quantizeChannel(g[i]);
+        out[3 * i + 2] = quantizeChannel(b[i]);
+    }
+#endif
+}
+
+// Mistura de frames RGB888 em ponto fixo: out = (from*(256-w) + to*w) >> 8,
+// w em [0, 256]. Os dois produtos somam no máximo 255*256, então a conta
+// cabe em 16 bits sem sinal.
+inline void blendBytes(const uchar* from, const uchar* to, int bytes, int weight, uchar* out)
+{
+    const int w = weight < 0 ? 0 : (weight > 256 ? 256 : weight);
+    int i = 0;
+#ifdef WDL_EFFECT_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i wTo = _mm_set1_epi16(static_cast<short>(w));
+    const __m128i wFrom = _mm_set1_epi16(static_cast<short>(256 - w));
+    for (; i + 16 <= bytes; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(to + i));
+        const __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), wFrom),
+                                         _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), wTo));
+        const __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), wFrom),
+                                         _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), wTo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)));
+    }
+#endif
+    for (; i < bytes; ++i) {
+        out[i] = static_cast<uchar>((from[i] * (256 - w) + to[i] * w) >> 8);
+    }
+}
+
+} // namespace EffectKernels
+
+#endif // EFFECT_KERNELS_H
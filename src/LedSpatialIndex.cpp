@@ -0,0 +1,217 @@
+#include "LedSpatialIndex.h"
+#include "EffectKernels.h"
+#include "RGBController.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr unsigned int NoLed = 0xFFFFFFFF; // célula vazia do matrix_map
+
+    bool hasMatrix(const zone& z)
+    {
+        return z.type == ZONE_TYPE_MATRIX && z.matrix_map && z.matrix_map->map
+            && z.matrix_map->height > 0 && z.matrix_map->width > 0;
+    }
+
+    // Faixas de uma zona dentro do retângulo do dispositivo
+    unsigned int zoneRows(const zone& z)
+    {
+        return hasMatrix(z) ? z.matrix_map->height : 1;
+    }
+
+    // Retângulo posicionado pelo usuário, ou inválido
+    QRectF placementFor(const RGBController* ctrl, const QVector<LedSpatialIndex::DevicePlacement>& placements)
+    {
+        const QString name = QString::fromStdString(ctrl->name);
+        const QString location = QString::fromStdString(ctrl->location);
+        for (const LedSpatialIndex::DevicePlacement& p : placements)
+        {
+            if (p.device == name && (p.location.isEmpty() || p.location == location) && p.rect.isValid())
+            {
+                return p.rect;
+            }
+        }
+        return QRectF();
+    }
+}
+
+void LedSpatialIndex::buildLayout(const std::vector<RGBController*>& controllers,
+                                  QVector<DriverProtocol::DeviceFrameEntry>& layout)
+{
+    layout.resize(0);
+    quint32 totalLeds = 0;
+    for (std::size_t di = 0; di < controllers.size(); ++di)
+    {
+        RGBController* ctrl = controllers[di];
+        if (!ctrl) continue;
+
+        // Tabela device/zona do frame endereçado
+        for (std::size_t zi = 0; zi < ctrl->zones.size(); ++zi)
+        {
+            DriverProtocol::DeviceFrameEntry entry;
+            entry.deviceId = static_cast<quint16>(di);
+            entry.zoneId   = static_cast<quint16>(zi);
+            entry.offset   = totalLeds;
+            entry.count    = ctrl->zones[zi].leds_count;
+            if (entry.count == 0) continue;
+            layout.append(entry);
+            totalLeds += entry.count;
+        }
+    }
+}
+
+void LedSpatialIndex::build(const std::vector<RGBController*>& controllers, const QVector<DevicePlacement>& placements)
+{
+    buildLayout(controllers, m_layout);
+    m_count = m_layout.isEmpty() ? 1 : static_cast<int>(m_layout.last().offset + m_layout.last().count);
+
+    const int planeSize = EffectKernels::paddedCount(m_count);
+    m_x.fill(0.0f, planeSize);
+    m_y.fill(0.0f, planeSize);
+
+    float* px = m_x.data();
+    float* py = m_y.data();
+    int autoColumn = 0;
+    int entryIndex = 0;
+    while (entryIndex < m_layout.size())
+    {
+        const quint16 deviceId = m_layout[entryIndex].deviceId;
+        const RGBController* ctrl = controllers[deviceId];
+
+        int lastEntry = entryIndex;
+        unsigned int rows = 0;
+        for (; lastEntry < m_layout.size() && m_layout[lastEntry].deviceId == deviceId; ++lastEntry)
+        {
+            rows += zoneRows(ctrl->zones[m_layout[lastEntry].zoneId]);
+        }
+
+        QRectF rect = placementFor(ctrl, placements);
+        if (!rect.isValid())
+        {
+            rect = QRectF(autoColumn++, 0.0, 1.0, 1.0);
+        }
+        const double rowHeight = rect.height() / rows;
+        double bandTop = rect.top();
+
+        for (; entryIndex < lastEntry; ++entryIndex)
+        {
+            const DriverProtocol::DeviceFrameEntry& entry = m_layout[entryIndex];
+            const zone& z = ctrl->zones[entry.zoneId];
+            const unsigned int bandRows = zoneRows(z);
+            float* zx = px + entry.offset;
+            float* zy = py + entry.offset;
+
+            if (hasMatrix(z))
+            {
+                // Matriz: célula (linha, coluna) de cada LED pelo matrix_map;
+                // LEDs fora do mapa ficam no centro da faixa
+                const matrix_map_type* map = z.matrix_map;
+                const double colWidth = rect.width() / map->width;
+                std::fill(zx, zx + entry.count, static_cast<float>(rect.center().x()));
+                std::fill(zy, zy + entry.count, static_cast<float>(bandTop + rowHeight * bandRows / 2.0));
+                for (unsigned int row = 0; row < map->height; ++row)
+                {
+                    for (unsigned int col = 0; col < map->width; ++col)
+                    {
+                        const unsigned int led = map->map[row * map->width + col];
+                        if (led == NoLed || led >= entry.count) continue;
+                        zx[led] = static_cast<float>(rect.left() + (col + 0.5) * colWidth);
+                        zy[led] = static_cast<float>(bandTop + (row + 0.5) * rowHeight);
+                    }
+                }
+            }
+            else if (z.type == ZONE_TYPE_SINGLE)
+            {
+                std::fill(zx, zx + entry.count, static_cast<float>(rect.center().x()));
+                std::fill(zy, zy + entry.count, static_cast<float>(bandTop + rowHeight / 2.0));
+            }
+            else
+            {
+                // Linear: fileira da esquerda para a direita
+                const double step = rect.width() / entry.count;
+                for (quint32 i = 0; i < entry.count; ++i)
+                {
+                    zx[i] = static_cast<float>(rect.left() + (i + 0.5) * step);
+                    zy[i] = static_cast<float>(bandTop + rowHeight / 2.0);
+                }
+            }
+            bandTop += rowHeight * bandRows;
+        }
+    }
+
+    buildProjections();
+}
+
+void LedSpatialIndex::buildProjections()
+{
+    const int planeSize = m_x.size();
+    const float* px = m_x.constData();
+    const float* py = m_y.constData();
+
+    float minX = px[0], maxX = px[0], minY = py[0], maxY = py[0];
+    for (int i = 1; i < m_count; ++i)
+    {
+        minX = std::min(minX, px[i]);
+        maxX = std::max(maxX, px[i]);
+        minY = std::min(minY, py[i]);
+        maxY = std::max(maxY, py[i]);
+    }
+    m_canvas = QRectF(minX, minY, maxX - minX, maxY - minY);
+
+    // Eixo degenerado (uma fileira/coluna): tudo no meio
+    const float spanX = maxX - minX;
+    const float spanY = maxY - minY;
+
+    for (QVector<float>& table : m_projections)
+    {
+        table.fill(0.0f, planeSize);
+    }
+    m_angle.fill(0.0f, planeSize);
+
+    float* forward = m_projections[static_cast<int>(EffectDirection::Forward)].data();
+    float* down    = m_projections[static_cast<int>(EffectDirection::Down)].data();
+    float* outward = m_projections[static_cast<int>(EffectDirection::Outward)].data();
+    float* angle   = m_angle.data();
+
+    float maxRadius = 0.0f;
+    for (int i = 0; i < m_count; ++i)
+    {
+        forward[i] = spanX > 0.0f ? (px[i] - minX) / spanX : 0.5f;
+        down[i]    = spanY > 0.0f ? (py[i] - minY) / spanY : 0.5f;
+
+        // Distância e ângulo no canvas normalizado, para o centro não
+        // depender da proporção do arranjo
+        const float dx = spanX > 0.0f ? forward[i] - 0.5f : 0.0f;
+        const float dy = spanY > 0.0f ? down[i] - 0.5f : 0.0f;
+        outward[i] = std::sqrt(dx * dx + dy * dy);
+        maxRadius = std::max(maxRadius, outward[i]);
+
+        if (spanY > 0.0f && spanX > 0.0f)
+        {
+            const float turns = std::atan2(dy, dx) / 6.28318530718f;
+            angle[i] = turns < 0.0f ? turns + 1.0f : turns;
+        }
+        else
+        {
+            // Uma fileira: a roda percorre o eixo como um anel
+            angle[i] = spanX > 0.0f ? forward[i] : down[i];
+        }
+        angle[i] = std::min(angle[i], 0.99999994f);
+    }
+    for (int i = 0; i < m_count; ++i)
+    {
+        outward[i] = maxRadius > 0.0f ? outward[i] / maxRadius : 0.0f;
+    }
+
+    EffectKernels::reverse(forward, planeSize, m_projections[static_cast<int>(EffectDirection::Reverse)].data());
+    EffectKernels::reverse(down, planeSize, m_projections[static_cast<int>(EffectDirection::Up)].data());
+    EffectKernels::reverse(outward, planeSize, m_projections[static_cast<int>(EffectDirection::Inward)].data());
+}
+
+const float* LedSpatialIndex::projection(EffectDirection direction) const
+{
+    const int index = static_cast<int>(direction);
+    return m_projections[index >= 0 && index < EffectDirectionCount ? index : 0].constData();
+}
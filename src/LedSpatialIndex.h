@@ -0,0 +1,69 @@
+#ifndef LED_SPATIAL_INDEX_H
+#define LED_SPATIAL_INDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QRectF>
+
+#include <vector>
+
+#include "../driver/common/DeviceFrame.h"
+#include "EffectEngine.h"
+
+class RGBController;
+
+// Posição de cada LED no canvas virtual, na ordem do frame do worker.
+//
+// Cada dispositivo ocupa um retângulo do canvas: o posicionamento do
+// usuário (DevicePlacement) ou, sem ele, uma célula 1x1 à direita do
+// anterior. Dentro do retângulo as zonas empilham em faixas: matriz usa o
+// matrix_map (linhas x colunas), linear vira uma fileira e single um ponto
+// central. Reconstruído a cada mudança na lista de dispositivos.
+//
+// Para os efeitos, uma tabela por EffectDirection já projetada e normalizada
+// em [0, 1] (mais a de ângulo da roda): avaliar um efeito é uma passada
+// linear sobre um plano contíguo, sem geometria por frame.
+class LedSpatialIndex
+{
+public:
+    // Retângulo em unidades do canvas (dispositivo automático = 1x1).
+    // location vazio vale para qualquer dispositivo com esse nome.
+    struct DevicePlacement
+    {
+        QString device;
+        QString location;
+        QRectF  rect;
+    };
+
+    // Zonas não vazias de cada controlador em sequência: a ordem do frame
+    static void buildLayout(const std::vector<RGBController*>& controllers,
+                            QVector<DriverProtocol::DeviceFrameEntry>& layout);
+
+    void build(const std::vector<RGBController*>& controllers, const QVector<DevicePlacement>& placements);
+
+    // Sem LEDs o índice tem um ponto só (o triplet plano do frame)
+    int ledCount() const { return m_count; }
+    const QVector<DriverProtocol::DeviceFrameEntry>& layout() const { return m_layout; }
+    QRectF canvas() const { return m_canvas; }
+
+    // Planos com capacidade EffectKernels::paddedCount(ledCount())
+    int planeSize() const { return m_angle.size(); }
+    const float* x() const { return m_x.constData(); }
+    const float* y() const { return m_y.constData(); }
+    const float* projection(EffectDirection direction) const;
+    const float* angle() const { return m_angle.constData(); }
+
+private:
+    int m_count = 0;
+    QVector<DriverProtocol::DeviceFrameEntry> m_layout;
+    QRectF m_canvas;
+
+    QVector<float> m_x;
+    QVector<float> m_y;
+    QVector<float> m_projections[EffectDirectionCount];
+    QVector<float> m_angle;
+
+    void buildProjections();
+};
+
+#endif // LED_SPATIAL_INDEX_H
@@ -0,0 +1,130 @@
+#include "RegistryColorSource.h"
+#include "WindowsDynamicLightingSync.h"
+
+#ifdef Q_OS_WIN
+#include <QWinEventNotifier>
+#include <windows.h>
+
+#ifndef REG_NOTIFY_THREAD_AGNOSTIC
+#define REG_NOTIFY_THREAD_AGNOSTIC 0x10000000L
+#endif
+#endif
+
+RegistryColorSource::RegistryColorSource(QObject* parent)
+    : ColorSource(parent)
+{
+}
+
+RegistryColorSource::~RegistryColorSource()
+{
+    stop();
+}
+
+QString RegistryColorSource::describe() const
+{
+    return QStringLiteral("registry (DWM ColorizationColor)");
+}
+
+#ifdef Q_OS_WIN
+
+bool RegistryColorSource::start()
+{
+    stop();
+
+    HKEY key = nullptr;
+    if (RegOpenKeyExW(HKEY_CURRENT_USER, L"Software\\Microsoft\\Windows\\DWM", 0, KEY_QUERY_VALUE | KEY_NOTIFY, &key) != ERROR_SUCCESS)
+    {
+        WDLLogger::Log(WDLLogger::Warning, "Color source: could not open the DWM registry key.");
+        return false;
+    }
+    m_key = key;
+    m_event = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (!m_event)
+    {
+        stop();
+        return false;
+    }
+
+    m_notifier = new QWinEventNotifier(static_cast<HANDLE>(m_event), this);
+    connect(m_notifier, &QWinEventNotifier::activated, this, [this]() {
+        // A notificação é de uso único: rearmar antes de ler para não perder
+        // uma escrita entre a leitura e o próximo registro
+        arm();
+        readValue();
+    });
+
+    if (!arm())
+    {
+        WDLLogger::Log(WDLLogger::Warning, "Color source: RegNotifyChangeKeyValue failed.");
+        stop();
+        return false;
+    }
+    readValue();
+    return true;
+}
+
+void RegistryColorSource::stop()
+{
+    if (m_notifier)
+    {
+        m_notifier->setEnabled(false);
+        delete m_notifier;
+        m_notifier = nullptr;
+    }
+    // Fechar a chave cancela a notificação pendente
+    if (m_key)
+    {
+        RegCloseKey(static_cast<HKEY>(m_key));
+        m_key = nullptr;
+    }
+    if (m_event)
+    {
+        CloseHandle(static_cast<HANDLE>(m_event));
+        m_event = nullptr;
+    }
+}
+
+bool RegistryColorSource::arm()
+{
+    // Thread-agnostic: a notificação não depende da thread que a registrou
+    const LONG rc = RegNotifyChangeKeyValue(static_cast<HKEY>(m_key), FALSE,
+                                            REG_NOTIFY_CHANGE_LAST_SET | REG_NOTIFY_THREAD_AGNOSTIC,
+                                            static_cast<HANDLE>(m_event), TRUE);
+    return rc == ERROR_SUCCESS;
+}
+
+void RegistryColorSource::readValue()
+{
+    DWORD argb = 0;
+    DWORD size = sizeof(argb);
+    DWORD type = 0;
+    if (RegQueryValueExW(static_cast<HKEY>(m_key), L"ColorizationColor", nullptr, &type,
+                         reinterpret_cast<LPBYTE>(&argb), &size) != ERROR_SUCCESS || type != REG_DWORD)
+    {
+        return;
+    }
+    // Interpreta como 0xAARRGGBB
+    updateColor(QColor((argb >> 16) & 0xFF, (argb >> 8) & 0xFF, argb & 0xFF));
+}
+
+#else
+
+bool RegistryColorSource::start()
+{
+    return false;
+}
+
+void RegistryColorSource::stop()
+{
+}
+
+bool RegistryColorSource::arm()
+{
+    return false;
+}
+
+void RegistryColorSource::readValue()
+{
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef REGISTRY_COLOR_SOURCE_H
+#define REGISTRY_COLOR_SOURCE_H
+
+#include "ColorSource.h"
+
+class QWinEventNotifier;
+
+// Cor de acentuação do Windows (DWM ColorizationColor, 0xAARRGGBB). O valor
+// é lido uma vez no start() e de novo só quando RegNotifyChangeKeyValue
+// sinaliza uma escrita na chave; o evento é observado por um
+// QWinEventNotifier na thread dona da fonte.
+class RegistryColorSource : public ColorSource
+{
+    Q_OBJECT
+public:
+    explicit RegistryColorSource(QObject* parent = nullptr);
+    ~RegistryColorSource() override;
+
+    bool start() override;
+    void stop() override;
+    QString describe() const override;
+
+private:
+    // HKEY e HANDLE (windows.h fica fora do header)
+    void* m_key = nullptr;
+    void* m_event = nullptr;
+    QWinEventNotifier* m_notifier = nullptr;
+
+    bool arm();
+    void readValue();
+};
+
+#endif // REGISTRY_COLOR_SOURCE_H
@@ -0,0 +1,48 @@
+#ifndef SNAPSHOT_BUFFER_H
+#define SNAPSHOT_BUFFER_H
+
+#include <atomic>
+
+// Triple buffer lock-free com um produtor e um consumidor. O produtor
+// preenche back() e publica; o consumidor pega o snapshot mais recente com
+// take() e lê front() até o próximo take(). Cada buffer pertence a um lado
+// por vez, então T pode ter membros não atômicos (QString etc.). Snapshots
+// não lidos são sobrescritos: o consumidor só vê o último.
+template <typename T>
+class SnapshotBuffer
+{
+public:
+    // Produtor: buffer a preencher por inteiro (contém um snapshot antigo)
+    T& back() { return m_slots[m_back]; }
+
+    void publish()
+    {
+        const int previous = m_middle.exchange(m_back | FreshBit, std::memory_order_acq_rel);
+        m_back = previous & IndexMask;
+    }
+
+    // Consumidor: true se havia um snapshot novo, agora em front()
+    bool take()
+    {
+        if (!(m_middle.load(std::memory_order_relaxed) & FreshBit))
+        {
+            return false;
+        }
+        const int previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & IndexMask;
+        return true;
+    }
+
+    const T& front() const { return m_slots[m_front]; }
+
+private:
+    static constexpr int IndexMask = 0x3;
+    static constexpr int FreshBit  = 0x4;
+
+    T m_slots[3];
+    std::atomic<int> m_middle { 1 };
+    int m_back  = 0; // só o produtor
+    int m_front = 2; // só o consumidor
+};
+
+#endif // SNAPSHOT_BUFFER_H
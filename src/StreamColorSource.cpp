@@ -0,0 +1,183 @@
+#include "StreamColorSource.h"
+#include "WindowsDynamicLightingSync.h"
+
+#include <QFileSystemWatcher>
+#include <QSocketNotifier>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QFile>
+#include <QStringList>
+
+#include <cstdio>
+#ifndef Q_OS_WIN
+#include <unistd.h>
+#endif
+
+// ---------------- FileColorSource -------------------------------------------
+
+FileColorSource::FileColorSource(const QString& path, QObject* parent)
+    : ColorSource(parent)
+    , m_path(path)
+{
+}
+
+QString FileColorSource::describe() const
+{
+    return QString("file %1").arg(m_path);
+}
+
+bool FileColorSource::start()
+{
+    stop();
+    m_watcher = new QFileSystemWatcher(this);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, [this]() {
+        readFile();
+        if (!m_watcher->files().contains(m_path))
+        {
+            m_watcher->addPath(m_path);
+        }
+    });
+    if (!m_watcher->addPath(m_path))
+    {
+        WDLLogger::Log(WDLLogger::Warning, QString("Color source: cannot watch '%1'.").arg(m_path));
+        stop();
+        return false;
+    }
+    readFile();
+    return true;
+}
+
+void FileColorSource::stop()
+{
+    delete m_watcher;
+    m_watcher = nullptr;
+}
+
+void FileColorSource::readFile()
+{
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return;
+    }
+    const QStringList lines = QString::fromUtf8(file.readAll()).split('\n');
+    for (int i = lines.size() - 1; i >= 0; --i)
+    {
+        QColor color;
+        if (ColorSource::parseColor(lines.at(i), color))
+        {
+            updateColor(color);
+            return;
+        }
+    }
+}
+
+// ---------------- StdinColorSource ------------------------------------------
+
+StdinColorSource::StdinColorSource(QObject* parent)
+    : ColorSource(parent)
+{
+}
+
+QString StdinColorSource::describe() const
+{
+    return QStringLiteral("stdin");
+}
+
+bool StdinColorSource::start()
+{
+#ifdef Q_OS_WIN
+    // QSocketNotifier não observa pipes/console no Windows
+    WDLLogger::Log(WDLLogger::Warning, "Color source: stdin is not supported on Windows.");
+    return false;
+#else
+    stop();
+    m_notifier = new QSocketNotifier(fileno(stdin), QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, [this]() {
+        char buffer[512];
+        const ssize_t n = ::read(fileno(stdin), buffer, sizeof(buffer));
+        if (n <= 0)
+        {
+            // EOF: mantém a última cor
+            m_notifier->setEnabled(false);
+            return;
+        }
+        m_pending.append(buffer, static_cast<int>(n));
+        int newline;
+        while ((newline = m_pending.indexOf('\n')) >= 0)
+        {
+            QColor color;
+            if (ColorSource::parseColor(QString::fromUtf8(m_pending.constData(), newline), color))
+            {
+                updateColor(color);
+            }
+            m_pending.remove(0, newline + 1);
+        }
+    });
+    return true;
+#endif
+}
+
+void StdinColorSource::stop()
+{
+    delete m_notifier;
+    m_notifier = nullptr;
+    m_pending.clear();
+}
+
+// ---------------- SocketColorSource -----------------------------------------
+
+SocketColorSource::SocketColorSource(const QString& name, QObject* parent)
+    : ColorSource(parent)
+    , m_name(name)
+{
+}
+
+QString SocketColorSource::describe() const
+{
+    return QString("socket %1").arg(m_name);
+}
+
+bool SocketColorSource::start()
+{
+    stop();
+    m_server = new QLocalServer(this);
+    QLocalServer::removeServer(m_name);
+    if (!m_server->listen(m_name))
+    {
+        WDLLogger::Log(WDLLogger::Warning, QString("Color source: cannot listen on '%1': %2").arg(m_name, m_server->errorString()));
+        stop();
+        return false;
+    }
+    connect(m_server, &QLocalServer::newConnection, this, [this]() {
+        while (QLocalSocket* client = m_server->nextPendingConnection())
+        {
+            connect(client, &QLocalSocket::readyRead, this, [this, client]() { readClient(client); });
+            connect(client, &QLocalSocket::disconnected, client, &QObject::deleteLater);
+        }
+    });
+    return true;
+}
+
+void SocketColorSource::stop()
+{
+    if (m_server)
+    {
+        m_server->close();
+        delete m_server;
+        m_server = nullptr;
+        QLocalServer::removeServer(m_name);
+    }
+}
+
+void SocketColorSource::readClient(QLocalSocket* client)
+{
+    while (client->canReadLine())
+    {
+        QColor color;
+        if (ColorSource::parseColor(QString::fromUtf8(client->readLine()), color))
+        {
+            updateColor(color);
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef STREAM_COLOR_SOURCE_H
+#define STREAM_COLOR_SOURCE_H
+
+#include "ColorSource.h"
+
+#include <QByteArray>
+
+class QFileSystemWatcher;
+class QSocketNotifier;
+class QLocalServer;
+class QLocalSocket;
+
+// Fontes de teste: uma cor por linha (ColorSource::parseColor). Servem para
+// exercitar o pipeline fora do Windows ou sem mexer na cor do sistema.
+
+// Última linha válida do arquivo, relida a cada mudança. Editores costumam
+// substituir o arquivo, então o caminho volta ao watcher após cada aviso.
+class FileColorSource : public ColorSource
+{
+    Q_OBJECT
+public:
+    explicit FileColorSource(const QString& path, QObject* parent = nullptr);
+
+    bool start() override;
+    void stop() override;
+    QString describe() const override;
+    bool requiresPlatform() const override { return false; }
+
+private:
+    QString m_path;
+    QFileSystemWatcher* m_watcher = nullptr;
+
+    void readFile();
+};
+
+// Entrada padrão, lida quando o QSocketNotifier acusa dados (fd 0)
+class StdinColorSource : public ColorSource
+{
+    Q_OBJECT
+public:
+    explicit StdinColorSource(QObject* parent = nullptr);
+
+    bool start() override;
+    void stop() override;
+    QString describe() const override;
+    bool requiresPlatform() const override { return false; }
+
+private:
+    QSocketNotifier* m_notifier = nullptr;
+    QByteArray m_pending; // linha incompleta
+};
+
+// QLocalServer: cada cliente envia cores, uma por linha
+class SocketColorSource : public ColorSource
+{
+    Q_OBJECT
+public:
+    explicit SocketColorSource(const QString& name, QObject* parent = nullptr);
+
+    bool start() override;
+    void stop() override;
+    QString describe() const override;
+    bool requiresPlatform() const override { return false; }
+
+private:
+    QString m_name;
+    QLocalServer* m_server = nullptr;
+
+    void readClient(QLocalSocket* client);
+};
+
+#endif // STREAM_COLOR_SOURCE_H
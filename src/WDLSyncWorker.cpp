@@ -0,0 +1,1164 @@
+#include "WDLSyncWorker.h"
+#include "WindowsDynamicLightingSync.h"
+
+#include <QColor>
+#include <QCoreApplication>
+#include <QtEndian>
+#include <QThread>
+#include <QRandomGenerator>
+#include "RGBController.h"
+#include "ResourceManagerInterface.h"
+#include <algorithm>
+#include <vector>
+#include "../driver/common/DriverProtocol.h"
+#include "../driver/common/FrameDelta.h"
+#include "EffectKernels.h"
+
+WDLSyncWorker::WDLSyncWorker(ResourceManagerInterface* resourceManager, const Settings& settings, QObject* parent)
+    : QObject(parent)
+    , m_resourceManager(resourceManager)
+    , m_settings(settings)
+{
+    // Capacidade reservada: resize(0) entre mensagens não libera o buffer
+    m_txBuffer.reserve(64 * 1024);
+
+    // Lista inicial lida na thread da UI; as mudanças seguintes chegam por
+    // invalidateControllers
+    if (m_resourceManager)
+    {
+        m_controllers = m_resourceManager->GetRGBControllers();
+    }
+}
+
+WDLSyncWorker::~WDLSyncWorker()
+{
+}
+
+const SyncStatus* WDLSyncWorker::takeStatus()
+{
+    return m_status.take() ? &m_status.front() : nullptr;
+}
+
+void WDLSyncWorker::start()
+{
+    // Timers e socket criados aqui para pertencerem à thread do worker
+    if (!m_syncTimer)
+    {
+        m_syncTimer = new QTimer(this);
+        m_syncTimer->setTimerType(Qt::PreciseTimer);
+        m_syncTimer->setSingleShot(true);
+        connect(m_syncTimer, &QTimer::timeout, this, &WDLSyncWorker::onSyncTick);
+    }
+    if (!m_idleTimer)
+    {
+        m_idleTimer = new QTimer(this);
+        m_idleTimer->setSingleShot(true);
+        connect(m_idleTimer, &QTimer::timeout, this, &WDLSyncWorker::requestFrame);
+    }
+    if (!m_linkTimer)
+    {
+        m_linkTimer = new QTimer(this);
+        connect(m_linkTimer, &QTimer::timeout, this, &WDLSyncWorker::onLinkProbe);
+    }
+    m_linkTimer->start(LinkProbeIntervalMs);
+
+    if (!m_reconnectTimer)
+    {
+        m_reconnectTimer = new QTimer(this);
+        m_reconnectTimer->setSingleShot(true);
+        connect(m_reconnectTimer, &QTimer::timeout, this, &WDLSyncWorker::onReconnectTimer);
+    }
+
+    // Etapa 4 — conectar ao driver via Named Pipe (QLocalSocket); o
+    // resultado chega pelos sinais do socket, sem segurar o start
+    m_reconnectEnabled = true;
+    ConnectToVirtualDriver();
+
+    // Fonte da cor na thread do worker: os avisos chegam pelo event loop dela
+    if (!m_colorSource)
+    {
+        m_colorSource = ColorSource::create(m_settings.colorSource, this);
+        if (m_colorSource)
+        {
+            connect(m_colorSource, &ColorSource::colorChanged, this, [this]() {
+                ++m_sourceChanges;
+                startTransition();
+                requestFrame();
+            });
+        }
+    }
+    if (m_colorSource && m_colorSource->start())
+    {
+        WDLLogger::Log(WDLLogger::Info, QString("Color source: %1").arg(m_colorSource->describe()));
+    }
+    else
+    {
+        WDLLogger::Log(WDLLogger::Warning, QString("Color source '%1' unavailable; using white.").arg(m_settings.colorSource));
+        delete m_colorSource;
+        m_colorSource = nullptr;
+    }
+
+    rebuildLedIndex();
+    m_effectClock.start();
+    requestFrame();
+    publishStatus(true);
+}
+
+void WDLSyncWorker::shutdown()
+{
+    if (m_syncTimer) m_syncTimer->stop();
+    if (m_idleTimer) m_idleTimer->stop();
+    if (m_linkTimer) m_linkTimer->stop();
+    if (m_colorSource) m_colorSource->stop();
+    m_reconnectEnabled = false;
+    if (m_reconnectTimer) m_reconnectTimer->stop();
+    // Espera os jobs em andamento: controladores não são tocados depois daqui
+    m_devicePool.reset();
+    WDLLogger::Log(WDLLogger::Info, QString("Sync session: %1 ticks, %2 device updates, %3 skipped unchanged, "
+                                            "%4 mode switches, %5 unchanged frames not sent to driver, "
+                                            "%6 past tick deadline, %7 still busy, "
+                                            "%8 driver frames coalesced (send queue peak %9)")
+                    .arg(m_ticks)
+                    .arg(m_deviceUpdates.load())
+                    .arg(m_deviceSkips.load())
+                    .arg(m_modeSwitches.load())
+                    .arg(m_framesUnchanged)
+                    .arg(m_deadlineMisses.load())
+                    .arg(m_devicesBusy.load())
+                    .arg(m_sendQueue.framesCoalesced())
+                    .arg(m_sendQueue.peakDepth()));
+    DisconnectFromVirtualDriver();
+    publishStatus(true);
+}
+
+void WDLSyncWorker::setSyncEnabled(bool enabled)
+{
+    m_settings.syncEnabled = enabled;
+    if (enabled) {
+        requestFrame();
+    } else {
+        if (m_syncTimer) m_syncTimer->stop();
+        if (m_idleTimer) m_idleTimer->stop();
+    }
+}
+
+void WDLSyncWorker::setSyncInterval(int intervalMs)
+{
+    // Vale a partir do próximo agendamento
+    m_settings.syncIntervalMs = intervalMs;
+}
+
+void WDLSyncWorker::setAdaptiveInterval(bool enabled)
+{
+    m_settings.adaptiveInterval = enabled;
+    publishStatus(true);
+}
+
+void WDLSyncWorker::setBrightnessEnabled(bool enabled)
+{
+    m_settings.brightnessEnabled = enabled;
+    invalidateLuts();
+    sendBrightness();
+    requestFrame();
+}
+
+void WDLSyncWorker::setBrightness(double value)
+{
+    m_settings.brightness = value;
+    if (m_settings.brightnessEnabled) {
+        invalidateLuts();
+        sendBrightness();
+        requestFrame();
+    }
+}
+
+void WDLSyncWorker::setEffect(const EffectParams& params)
+{
+    m_settings.effect = params;
+    startTransition();
+    requestFrame();
+}
+
+void WDLSyncWorker::setTransition(int durationMs, int fps)
+{
+    m_settings.transitionMs = durationMs;
+    m_settings.transitionFps = fps;
+    if (durationMs <= 0)
+    {
+        m_transitionActive = false;
+    }
+}
+
+void WDLSyncWorker::startTransition()
+{
+    // Parte do que está nos LEDs agora (no meio de outra transição, do
+    // frame misturado); sem frame exibido não há de onde partir
+    if (m_settings.transitionMs <= 0 || m_frameColors.isEmpty())
+    {
+        return;
+    }
+    m_transitionFrom = m_frameColors;
+    m_transitionClock.start();
+    if (!m_transitionActive)
+    {
+        ++m_transitions;
+    }
+    m_transitionActive = true;
+}
+
+int WDLSyncWorker::tickIntervalMs() const
+{
+    // Transição na sua taxa, mas não acima do que os dispositivos aguentam
+    if (m_transitionActive)
+    {
+        const int transitionMs = qMax(1, 1000 / qMax(1, m_settings.transitionFps));
+        return m_settings.adaptiveInterval ? qMax(transitionMs, m_scheduler.sustainableMs()) : transitionMs;
+    }
+    return m_settings.adaptiveInterval ? m_scheduler.intervalMs() : m_settings.syncIntervalMs;
+}
+
+void WDLSyncWorker::setDevicePlacements(const QVector<LedSpatialIndex::DevicePlacement>& placements)
+{
+    m_settings.devicePlacements = placements;
+    rebuildLedIndex();
+    requestFrame();
+}
+
+void WDLSyncWorker::setCalibrationProfiles(const QVector<CalibrationProfile>& profiles)
+{
+    m_settings.calibrationProfiles = profiles;
+    invalidateLuts();
+    requestFrame();
+}
+
+void WDLSyncWorker::setPlatformReady(bool ready)
+{
+    m_platformReady = ready;
+    requestFrame();
+}
+
+void WDLSyncWorker::invalidateControllers(const std::vector<RGBController*>& controllers)
+{
+    // Roda na thread do worker, entre ticks: nenhum tick usa a lista antiga
+    // depois daqui. Jobs atrasados de ticks anteriores ainda podem estar
+    // com um controlador removido: o pool é drenado antes do retorno (e
+    // recriado no próximo despacho)
+    m_devicePool.reset();
+    m_controllers = controllers;
+
+    // Mesmo ponteiro pode ser outro dispositivo: o estado aplicado recomeça,
+    // mas o slot (e o seu busy) continua o do controlador
+    for (auto it = m_devices.begin(); it != m_devices.end();)
+    {
+        if (std::find(controllers.cbegin(), controllers.cend(), it.key()) == controllers.cend())
+        {
+            it = m_devices.erase(it);
+        }
+        else
+        {
+            it.value()->resetApplied();
+            ++it;
+        }
+    }
+    m_busCosts.clear();
+    rebuildLedIndex();
+    requestFrame();
+}
+
+void WDLSyncWorker::requestFrame()
+{
+    if (!m_settings.syncEnabled || !m_syncTimer)
+    {
+        return;
+    }
+    // Já agendado: pedidos no mesmo intervalo viram um tick só
+    if (m_syncTimer->isActive())
+    {
+        return;
+    }
+    const int intervalMs = tickIntervalMs();
+    const qint64 sinceLastMs = m_lastTick.isValid() ? m_lastTick.elapsed() : intervalMs;
+    m_syncTimer->start(static_cast<int>(qMax<qint64>(0, intervalMs - sinceLastMs)));
+}
+
+void WDLSyncWorker::sendBrightness()
+{
+    const float value = m_settings.brightnessEnabled ? static_cast<float>(m_settings.brightness) : 1.0f;
+    sendSchema<DriverProtocol::SetBrightnessMsg>(value);
+}
+
+void WDLSyncWorker::onSyncTick()
+{
+    if (!m_settings.syncEnabled) return;
+    if (!m_resourceManager) return;
+
+    // Só sincroniza se o SO for compatível e a API estiver disponível
+    // (fontes de teste exercitam o pipeline em qualquer plataforma)
+    const bool testSource = m_colorSource && !m_colorSource->requiresPlatform();
+    if (!m_platformReady && !testSource) {
+        WDLLogger::Log(WDLLogger::Warning, "Sync skipped: OS or API not compatible/available.");
+        return;
+    }
+
+    // 1) Cor base: último valor da fonte (atualizado por aviso de mudança)
+    const QColor accentColorQt = m_colorSource ? m_colorSource->currentColor() : QColor(255, 255, 255);
+
+    // 2) Estado do efeito para a UI (publicado com throttle ao fim do tick)
+    m_red   = accentColorQt.red();
+    m_green = accentColorQt.green();
+    m_blue  = accentColorQt.blue();
+    ++m_ticks;
+    m_lastTick.start();
+    QElapsedTimer tickTimer;
+    tickTimer.start();
+
+    // 3) Monta o layout de todos os controladores e renderiza o efeito nele;
+    //    o frame é a referência para dispositivos e driver
+    LedSpatialIndex::buildLayout(m_controllers, m_frameLayout);
+    if (m_frameLayout != m_ledIndex.layout() || m_ledIndex.ledCount() == 0)
+    {
+        WDLLogger::Log(WDLLogger::Debug, "LED layout changed without a device list change; rebuilding spatial index.");
+        rebuildLedIndex();
+    }
+
+    // Sem dispositivos o engine tem um LED só: o triplet plano
+    EffectParams effect = m_settings.effect;
+    effect.primary = accentColorQt;
+    const int frameBytes = m_ledIndex.ledCount() * 3;
+    if (m_transitionActive && m_transitionFrom.size() != frameBytes)
+    {
+        // Layout mudou no meio da transição: não há frame correspondente
+        m_transitionActive = false;
+    }
+    QElapsedTimer renderTimer;
+    renderTimer.start();
+    QByteArray& target = m_transitionActive ? m_renderFrame : m_frameColors;
+    target.resize(frameBytes);
+    m_effects.render(effect, m_effectClock.nsecsElapsed() / 1e9, m_ledIndex, target.data());
+    m_renderNs = renderTimer.nsecsElapsed();
+
+    // Transição: peso Q8 pelo tempo decorrido; no fim o alvo vale sozinho
+    if (m_transitionActive)
+    {
+        const qint64 weight = qMin<qint64>(256, m_transitionClock.elapsed() * 256 / m_settings.transitionMs);
+        m_frameColors.resize(frameBytes);
+        EffectKernels::blendBytes(reinterpret_cast<const uchar*>(m_transitionFrom.constData()),
+                                  reinterpret_cast<const uchar*>(m_renderFrame.constData()),
+                                  frameBytes, static_cast<int>(weight),
+                                  reinterpret_cast<uchar*>(m_frameColors.data()));
+        ++m_transitionFrames;
+        if (weight >= 256)
+        {
+            m_transitionActive = false;
+            m_transitionFrom.clear();
+        }
+    }
+
+    // 4) Atualiza os dispositivos em paralelo (até o prazo do tick)
+    const bool devicesDone = dispatchDevices(accentColorQt);
+
+    // 5) Enviar cores ao driver virtual: um único SetDeviceFrame com todas
+    //    as zonas (ou o triplet plano quando não há dispositivos); sem
+    //    conexão o frame é descartado e a reconexão segue pelo recuo
+    if (!sendLedFrame(m_frameLayout, m_frameColors) && isDriverConnected()) {
+        WDLLogger::Log(WDLLogger::Warning, "Failed to send LED frame to driver.");
+    }
+
+    // Custo do tick sem a espera pelos dispositivos (que não ocupa CPU
+    // aqui); dispositivos atrasados contam como pressão e fazem recuar
+    const int intervalBefore = m_scheduler.intervalMs();
+    m_scheduler.recordTick(tickTimer.nsecsElapsed() - m_dispatchWaitNs, !devicesDone);
+    if (m_scheduler.intervalMs() != intervalBefore)
+    {
+        WDLLogger::Log(WDLLogger::Debug, QString("Adaptive interval: %1 ms (tick %2 us, slowest bus '%3' %4 us, backoff %5)")
+                        .arg(m_scheduler.intervalMs())
+                        .arg(m_scheduler.tickCostNs() / 1000)
+                        .arg(m_scheduler.limitingBus())
+                        .arg(m_scheduler.busCostNs() / 1000)
+                        .arg(m_scheduler.backoff(), 0, 'f', 2));
+    }
+
+    // Animação, transição e dispositivos atrasados pedem o próximo tick
+    // (que recebe o frame mais novo); sem pendências, só a manutenção
+    if (!devicesDone || m_transitionActive || EffectEngine::isAnimated(effect.type)) {
+        requestFrame();
+    }
+    m_idleTimer->start(IdleRefreshMs);
+
+    publishStatus();
+}
+
+void WDLSyncWorker::rebuildLedIndex()
+{
+    if (!m_resourceManager)
+    {
+        return;
+    }
+    m_ledIndex.build(m_controllers, m_settings.devicePlacements);
+    const QRectF canvas = m_ledIndex.canvas();
+    WDLLogger::Log(WDLLogger::Debug, QString("Spatial index: %1 LEDs in %2 zones, canvas %3 x %4")
+                    .arg(m_ledIndex.ledCount())
+                    .arg(m_ledIndex.layout().size())
+                    .arg(canvas.width(), 0, 'f', 2)
+                    .arg(canvas.height(), 0, 'f', 2));
+}
+
+QString WDLSyncWorker::busKey(const RGBController* ctrl)
+{
+    // SMBus/I2C: vários dispositivos por barramento ("I2C: <barramento>, <endereço>");
+    // USB/HID e rede têm um canal por dispositivo
+    const QString location = QString::fromStdString(ctrl->location);
+    if (location.startsWith("I2C", Qt::CaseInsensitive) || location.startsWith("SMBus", Qt::CaseInsensitive))
+    {
+        const int comma = location.indexOf(',');
+        return comma > 0 ? location.left(comma) : location;
+    }
+    return location.isEmpty() ? QString::fromStdString(ctrl->name) : location;
+}
+
+void WDLSyncWorker::DeviceSlot::resetApplied()
+{
+    bus = busKey(controller);
+    modeSet = false;
+    mode = -1;
+    needsMode = false;
+    colorsValid = false;
+    colors.clear();
+    lutGeneration = 0;
+    costNs.store(0, std::memory_order_relaxed);
+}
+
+WDLSyncWorker::DeviceSlotPtr WDLSyncWorker::deviceSlot(RGBController* ctrl)
+{
+    DeviceSlotPtr& slot = m_devices[ctrl];
+    if (!slot)
+    {
+        slot = DeviceSlotPtr::create();
+        slot->controller = ctrl;
+        slot->bus = busKey(ctrl);
+    }
+    return slot;
+}
+
+WDLSyncWorker::BusFlag WDLSyncWorker::busInFlight(const QString& bus)
+{
+    BusFlag& flag = m_busInFlight[bus];
+    if (!flag)
+    {
+        flag = BusFlag::create(false);
+    }
+    return flag;
+}
+
+bool WDLSyncWorker::dispatchDevices(const QColor& fallback)
+{
+    const std::vector<RGBController*>& controllers = m_controllers;
+
+    for (QVector<DeviceSlotPtr>& group : m_busGroups)
+    {
+        group.resize(0);
+    }
+
+    // Cores alvo por controlador a partir do frame; o layout lista as zonas
+    // de cada dispositivo em sequência
+    int entryIndex = 0;
+    int pending = 0;
+    bool complete = true;
+    m_dispatchWaitNs = 0;
+    for (std::size_t di = 0; di < controllers.size(); ++di)
+    {
+        RGBController* ctrl = controllers[di];
+        if (!ctrl) continue;
+
+        DeviceSlotPtr slot = deviceSlot(ctrl);
+        if (slot->busy.load(std::memory_order_acquire) || busInFlight(slot->bus)->load(std::memory_order_acquire))
+        {
+            // Ele ou o seu barramento ainda no tick anterior: recebe o frame
+            // mais novo quando liberar
+            ++m_devicesBusy;
+            complete = false;
+            while (entryIndex < m_frameLayout.size() && m_frameLayout[entryIndex].deviceId == di) ++entryIndex;
+            continue;
+        }
+
+        if (slot->lutGeneration != m_lutGeneration)
+        {
+            const double brightness = m_settings.brightnessEnabled ? m_settings.brightness : 1.0;
+            slot->lut = ColorLut::compile(CalibrationProfile::match(m_settings.calibrationProfiles, ctrl), brightness);
+            slot->lutGeneration = m_lutGeneration;
+        }
+
+        // Frame -> cores do dispositivo: só consulta às tabelas por LED
+        const ColorLut& lut = slot->lut;
+        slot->target.assign(ctrl->colors.size(), ToRGBColor(lut.red[fallback.red()], lut.green[fallback.green()], lut.blue[fallback.blue()]));
+        for (; entryIndex < m_frameLayout.size() && m_frameLayout[entryIndex].deviceId == di; ++entryIndex)
+        {
+            const DriverProtocol::DeviceFrameEntry& entry = m_frameLayout[entryIndex];
+            const std::size_t start = ctrl->zones[entry.zoneId].start_idx;
+            const uchar* src = reinterpret_cast<const uchar*>(m_frameColors.constData()) + entry.offset * 3;
+            for (quint32 i = 0; i < entry.count && start + i < slot->target.size(); ++i, src += 3)
+            {
+                slot->target[start + i] = ToRGBColor(lut.red[src[0]], lut.green[src[1]], lut.blue[src[2]]);
+            }
+        }
+
+        // Modo custom uma vez por sessão, ou de novo se outro cliente do
+        // OpenRGB trocou o modo (o novo modo precisa receber as cores)
+        slot->needsMode = !slot->modeSet || ctrl->active_mode != slot->mode;
+
+        // Buffer do controlador igual ao último envio (sem escrita externa)
+        // e já com as cores do tick: nada a enviar ao dispositivo
+        if (!slot->needsMode && slot->colorsValid && ctrl->colors == slot->colors && slot->target == slot->colors)
+        {
+            ++m_deviceSkips;
+            continue;
+        }
+
+        slot->busy.store(true, std::memory_order_relaxed);
+        m_busGroups[slot->bus].append(slot);
+        ++pending;
+    }
+    measureBusCosts();
+    if (pending == 0)
+    {
+        return complete;
+    }
+
+    if (!m_devicePool)
+    {
+        m_devicePool.reset(new WorkStealingPool(qBound(2, QThread::idealThreadCount() / 2, 4)));
+    }
+
+    const quint64 missesBefore = m_deadlineMisses.load(std::memory_order_relaxed);
+    const qint64 nowNs = DriverProtocol::presentationClockNs();
+    const qint64 budgetNs = static_cast<qint64>(tickIntervalMs() * TickDeadlineFraction * 1e6);
+    QSharedPointer<TickBatch> batch = QSharedPointer<TickBatch>::create();
+    batch->deadlineNs = nowNs + budgetNs;
+
+    int jobs = 0;
+    for (const QVector<DeviceSlotPtr>& group : qAsConst(m_busGroups))
+    {
+        if (group.isEmpty()) continue;
+        const BusFlag inFlight = busInFlight(group.first()->bus);
+        inFlight->store(true, std::memory_order_relaxed);
+        m_devicePool->submit([this, batch, group, inFlight]() {
+            runDeviceGroup(*batch, group, inFlight);
+            batch->done.release();
+        });
+        ++jobs;
+    }
+
+    // Espera limitada ao prazo; jobs atrasados terminam sozinhos e liberam
+    // os seus slots
+    const int waitMs = static_cast<int>((batch->deadlineNs - nowNs + 999999) / 1000000);
+    QElapsedTimer waitTimer;
+    waitTimer.start();
+    const bool finished = batch->done.tryAcquire(jobs, waitMs);
+    m_dispatchWaitNs = waitTimer.nsecsElapsed();
+    return complete && finished && m_deadlineMisses.load(std::memory_order_relaxed) == missesBefore;
+}
+
+void WDLSyncWorker::runDeviceGroup(const TickBatch& batch, const QVector<DeviceSlotPtr>& group, const BusFlag& inFlight)
+{
+    for (const DeviceSlotPtr& slot : group)
+    {
+        RGBController* ctrl = slot->controller;
+        if (DriverProtocol::presentationClockNs() > batch.deadlineNs)
+        {
+            m_deadlineMisses.fetch_add(1, std::memory_order_relaxed);
+            slot->busy.store(false, std::memory_order_release);
+            continue;
+        }
+
+        const qint64 startNs = DriverProtocol::presentationClockNs();
+        if (slot->needsMode)
+        {
+            ctrl->SetCustomMode();
+            slot->modeSet = true;
+            slot->mode = ctrl->active_mode;
+            m_modeSwitches.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (ctrl->colors.size() == slot->target.size())
+        {
+            std::copy(slot->target.cbegin(), slot->target.cend(), ctrl->colors.begin());
+            ctrl->UpdateLEDs();
+            slot->colors = slot->target;
+            slot->colorsValid = true;
+            m_deviceUpdates.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Média móvel (1/4 da amostra nova) para o agendador
+        const qint64 costNs = DriverProtocol::presentationClockNs() - startNs;
+        const qint64 average = slot->costNs.load(std::memory_order_relaxed);
+        slot->costNs.store(average == 0 ? costNs : average + (costNs - average) / 4, std::memory_order_relaxed);
+        slot->busy.store(false, std::memory_order_release);
+    }
+    // Só agora o barramento aceita outro job
+    inFlight->store(false, std::memory_order_release);
+}
+
+void WDLSyncWorker::measureBusCosts()
+{
+    // Um barramento atualiza em série: o custo dele é a soma dos seus
+    // dispositivos, inclusive os sem mudança neste tick (pior caso)
+    for (qint64& cost : m_busCosts)
+    {
+        cost = 0;
+    }
+    for (const DeviceSlotPtr& slot : qAsConst(m_devices))
+    {
+        m_busCosts[slot->bus] += slot->costNs.load(std::memory_order_relaxed);
+    }
+
+    qint64 worstNs = 0;
+    QString worstBus;
+    for (auto it = m_busCosts.cbegin(); it != m_busCosts.cend(); ++it)
+    {
+        if (it.value() > worstNs)
+        {
+            worstNs = it.value();
+            worstBus = it.key();
+        }
+    }
+    m_scheduler.recordBusCost(worstNs, worstBus);
+}
+
+void WDLSyncWorker::publishStatus(bool force)
+{
+    // Percentis do enlace ordenam as janelas: só na cadência de publicação
+    if (!force && m_statusTimer.isValid() && m_statusTimer.elapsed() < StatusPublishIntervalMs)
+    {
+        return;
+    }
+    m_statusTimer.start();
+
+    SyncStatus& s = m_status.back();
+    s.effectKnown = m_ticks > 0;
+    s.red   = m_red;
+    s.green = m_green;
+    s.blue  = m_blue;
+    s.ticks = m_ticks;
+    s.effectType      = m_settings.effect.type;
+    s.effectDirection = m_settings.effect.direction;
+    s.secondary       = m_settings.effect.secondary;
+    s.renderUs        = m_renderNs / 1000;
+    s.transitionActive = m_transitionActive;
+    s.transitions      = m_transitions;
+    s.transitionFrames = m_transitionFrames;
+
+    s.adaptiveInterval = m_settings.adaptiveInterval;
+    s.intervalMs       = tickIntervalMs();
+    s.rateLimit        = m_scheduler.limit();
+    s.limitingBus      = m_scheduler.limitingBus();
+    s.tickCostUs       = m_scheduler.tickCostNs() / 1000;
+    s.busCostUs        = m_scheduler.busCostNs() / 1000;
+    s.backoff          = m_scheduler.backoff();
+
+    s.colorSource   = m_colorSource ? m_colorSource->describe() : QString();
+    s.sourceChanges = m_sourceChanges;
+
+    s.deviceUpdates   = m_deviceUpdates.load(std::memory_order_relaxed);
+    s.deviceSkips     = m_deviceSkips.load(std::memory_order_relaxed);
+    s.modeSwitches    = m_modeSwitches.load(std::memory_order_relaxed);
+    s.framesUnchanged = m_framesUnchanged;
+    s.deadlineMisses  = m_deadlineMisses.load(std::memory_order_relaxed);
+    s.devicesBusy     = m_devicesBusy.load(std::memory_order_relaxed);
+    s.poolSteals      = m_devicePool ? m_devicePool->steals() : 0;
+
+    s.driverConnected       = isDriverConnected();
+    s.connectionState       = m_connectionState;
+    s.reconnectAttempts     = m_reconnectAttempts;
+    s.nextRetryMs           = m_connectionState == DriverConnectionState::Backoff && m_reconnectTimer
+                            ? qMax(0, m_reconnectTimer->remainingTime()) : 0;
+    s.sendsDropped          = m_sendsDropped;
+    s.helloAcked            = m_helloAcked;
+    s.sharedTransportActive = m_sharedTransportActive;
+    s.capabilities          = m_helloAcked ? m_driverCaps.describe() : QString();
+
+    s.sendQueueDepth  = m_sendQueue.depth();
+    s.sendQueueBytes  = m_sendQueue.queuedBytes();
+    s.sendQueuePeak   = m_sendQueue.peakDepth();
+    s.framesCoalesced = m_sendQueue.framesCoalesced();
+
+    s.hasLinkSamples  = m_linkStats.hasSamples();
+    s.rtt             = m_linkStats.rtt();
+    s.oneWay          = m_linkStats.oneWay();
+    s.framesLost      = m_linkStats.framesLost();
+    s.framesReordered = m_linkStats.framesReordered();
+
+    m_status.publish();
+}
+
+bool WDLSyncWorker::isDriverConnected() const
+{
+    return m_driverSocket && m_driverSocket->state() == QLocalSocket::ConnectedState;
+}
+
+void WDLSyncWorker::ConnectToVirtualDriver()
+{
+    // Conecta ao servidor do driver via QLocalSocket
+    if (!m_driverSocket)
+    {
+        m_driverSocket.reset(new QLocalSocket(this));
+        connect(m_driverSocket.data(), &QLocalSocket::readyRead, this, [this]{
+            const qint64 available = m_driverSocket->bytesAvailable();
+            if (available <= 0) return;
+            char* dst = m_rxFramer.prepareWrite(static_cast<int>(available));
+            const qint64 n = m_driverSocket->read(dst, available);
+            if (n > 0) m_rxFramer.commitWrite(static_cast<int>(n));
+            m_rxFramer.consume([this](DriverProtocol::MessageType type, const DriverProtocol::PayloadView& payload) {
+                handleDriverMessage(type, payload);
+            });
+            if (m_rxFramer.hasError())
+            {
+                WDLLogger::Log(WDLLogger::Error, "Malformed frame header from driver; dropping connection.");
+                m_driverSocket->abort();
+            }
+        });
+        connect(m_driverSocket.data(), &QLocalSocket::bytesWritten, this, [this]{
+            pumpSendQueue();
+        });
+        connect(m_driverSocket.data(), &QLocalSocket::connected, this, &WDLSyncWorker::onDriverConnected);
+        connect(m_driverSocket.data(), &QLocalSocket::disconnected, this, [this]{
+            WDLLogger::Log(WDLLogger::Warning, "Driver socket disconnected.");
+            m_sendQueue.clear();
+            resetFrameReference();
+            releaseSharedTransport();
+            m_driverCaps = DriverProtocol::Capabilities();
+            m_helloAcked = false;
+            onDriverConnectionLost();
+        });
+        connect(m_driverSocket.data(), QOverload<QLocalSocket::LocalSocketError>::of(&QLocalSocket::errorOccurred), this, [this](QLocalSocket::LocalSocketError code){
+            // Servidor ausente/ocupado durante a tentativa: só agenda a próxima
+            if (m_connectionState != DriverConnectionState::Connected)
+            {
+                WDLLogger::Log(WDLLogger::Debug, QString("Driver connection attempt failed: %1").arg(static_cast<int>(code)));
+                onDriverConnectionLost();
+                return;
+            }
+            WDLLogger::Log(WDLLogger::Error, QString("Driver socket error: %1").arg(static_cast<int>(code)));
+        });
+    }
+
+    if (m_driverSocket->state() != QLocalSocket::UnconnectedState)
+    {
+        return;
+    }
+
+    setConnectionState(DriverConnectionState::Connecting);
+    m_reconnectTimer->start(ConnectTimeoutMs);
+    m_driverSocket->connectToServer(m_driverServerName);
+}
+
+void WDLSyncWorker::onDriverConnected()
+{
+    m_reconnectTimer->stop();
+    if (m_reconnectAttempts > 0)
+    {
+        WDLLogger::Log(WDLLogger::Info, QString("Connected to driver server '%1' after %2 failed attempts.")
+                        .arg(m_driverServerName).arg(m_reconnectAttempts));
+    }
+    else
+    {
+        WDLLogger::Log(WDLLogger::Info, QString("Connected to driver server '%1'.").arg(m_driverServerName));
+    }
+    m_reconnectAttempts = 0;
+    setConnectionState(DriverConnectionState::Connected);
+
+    // Nova conexão: o driver não tem referência, próximo frame é keyframe
+    m_sendQueue.clear();
+    resetFrameReference();
+    sendHello();
+    sendBrightness(); // driver reiniciado não guarda o brilho
+    requestFrame();
+}
+
+void WDLSyncWorker::onDriverConnectionLost()
+{
+    // Erro e disconnected podem chegar juntos para a mesma falha
+    if (!m_reconnectEnabled || m_connectionState == DriverConnectionState::Backoff)
+    {
+        if (!m_reconnectEnabled)
+        {
+            setConnectionState(DriverConnectionState::Disconnected);
+        }
+        return;
+    }
+
+    // Recuo exponencial com jitter de ±25%: vários clientes não sincronizam
+    // as tentativas quando o driver volta
+    const int exponent = qMin(m_reconnectAttempts, 16);
+    const int baseMs = qMin(ReconnectMaxMs, ReconnectBaseMs << exponent);
+    const int jitterMs = baseMs / 4;
+    const int delayMs = baseMs - jitterMs + static_cast<int>(QRandomGenerator::global()->bounded(2 * jitterMs + 1));
+    ++m_reconnectAttempts;
+
+    if (m_reconnectAttempts == 1)
+    {
+        WDLLogger::Log(WDLLogger::Warning, QString("Driver server '%1' unavailable; retrying with backoff.").arg(m_driverServerName));
+    }
+    WDLLogger::Log(WDLLogger::Debug, QString("Driver reconnect attempt %1 in %2 ms.").arg(m_reconnectAttempts).arg(delayMs));
+    setConnectionState(DriverConnectionState::Backoff);
+    m_reconnectTimer->start(delayMs);
+
+    // Depois do Backoff: um erro emitido pelo abort não agenda de novo
+    if (m_driverSocket && m_driverSocket->state() != QLocalSocket::UnconnectedState)
+    {
+        m_driverSocket->abort();
+    }
+}
+
+void WDLSyncWorker::onReconnectTimer()
+{
+    if (m_connectionState == DriverConnectionState::Connecting)
+    {
+        // Tentativa sem resposta dentro do prazo (pipe ocupado)
+        WDLLogger::Log(WDLLogger::Debug, "Driver connection attempt timed out.");
+        onDriverConnectionLost();
+        return;
+    }
+    ConnectToVirtualDriver();
+}
+
+void WDLSyncWorker::setConnectionState(DriverConnectionState state)
+{
+    if (m_connectionState == state)
+    {
+        return;
+    }
+    m_connectionState = state;
+    publishStatus(true);
+}
+
+void WDLSyncWorker::DisconnectFromVirtualDriver()
+{
+    m_reconnectEnabled = false;
+    if (m_reconnectTimer) m_reconnectTimer->stop();
+    releaseSharedTransport();
+    if (m_driverSocket)
+    {
+        if (m_driverSocket->state() == QLocalSocket::ConnectedState)
+        {
+            // Só no shutdown: dá ao driver a chance de ler o que está na fila
+            m_driverSocket->disconnectFromServer();
+            m_driverSocket->waitForDisconnected(200);
+        }
+        m_driverSocket.reset();
+    }
+    setConnectionState(DriverConnectionState::Disconnected);
+}
+
+bool WDLSyncWorker::ensureDriverConnection()
+{
+    // Sem conexão o envio é descartado; a reconexão segue pelo recuo
+    if (!isDriverConnected())
+    {
+        ++m_sendsDropped;
+        return false;
+    }
+    return true;
+}
+
+bool WDLSyncWorker::sendMessage(quint16 type, const QByteArray& payload, DriverSendQueue::Lane lane, qint64 seq)
+{
+    if (!ensureDriverConnection())
+    {
+        return false;
+    }
+
+    m_txBuffer.resize(0);
+    DriverProtocol::packInto(m_txBuffer, static_cast<DriverProtocol::MessageType>(type), payload.constData(), payload.size());
+    return writePacket(m_txBuffer, lane, seq);
+}
+
+bool WDLSyncWorker::writePacket(const QByteArray& packet, DriverSendQueue::Lane lane, qint64 seq)
+{
+    if (lane == DriverSendQueue::Lane::Frame)
+    {
+        // Frame substituído na fila não é perda: sai da conta do enlace
+        const qint64 replaced = m_sendQueue.enqueueFrame(packet, seq);
+        if (replaced != DriverSendQueue::NoSequence)
+        {
+            m_linkStats.onFrameCoalesced(static_cast<quint32>(replaced));
+        }
+    }
+    else if (!m_sendQueue.enqueueControl(packet))
+    {
+        // Controle não é descartado: driver parado de ler, refaz a conexão
+        WDLLogger::Log(WDLLogger::Error, "Driver send queue full (driver not reading); dropping connection.");
+        m_driverSocket->abort();
+        return false;
+    }
+    return pumpSendQueue();
+}
+
+bool WDLSyncWorker::pumpSendQueue()
+{
+    if (!isDriverConnected())
+    {
+        return false;
+    }
+    if (!m_sendQueue.pump(m_driverSocket.data()))
+    {
+        WDLLogger::Log(WDLLogger::Error, QString("sendMessage: write failed (%1)").arg(m_driverSocket->errorString()));
+        return false;
+    }
+    return true;
+}
+
+
+bool WDLSyncWorker::sendLedFrame(const QVector<DriverProtocol::DeviceFrameEntry>& layout, const QByteArray& rgb)
+{
+    using DriverProtocol::MessageType;
+
+    // Só usa codificações negociadas; sem HelloAck fica no SetLedColors legado
+    const bool useDelta       = m_driverCaps.has(DriverProtocol::EncodingDelta);
+    const bool useDeviceFrame = m_driverCaps.has(DriverProtocol::EncodingDeviceFrame) && !layout.isEmpty();
+
+    // Keyframe periódico, após reconexão/pedido do driver ou mudança de layout
+    const bool keyframeDue = m_keyframeRequested
+                          || !m_keyframeTimer.isValid()
+                          || m_keyframeTimer.elapsed() >= KeyframeIntervalMs
+                          || layout != m_lastSentLayout;
+
+    // Frame idêntico ao que o driver já tem: só o keyframe periódico reenvia
+    if (!keyframeDue && rgb == m_lastSentFrame)
+    {
+        ++m_framesUnchanged;
+        return true;
+    }
+
+    // Frame ainda na fila pode ser substituído por este: precisa ser
+    // autocontido, o driver nunca recebeu a referência do delta
+    if (useDelta && !keyframeDue && !m_sendQueue.framePending() && DriverProtocol::encodeDelta(m_lastSentFrame, rgb, m_deltaScratch))
+    {
+        if (!sendFrameMessage(MessageType::SetLedColorsDelta, m_deltaScratch))
+        {
+            return false;
+        }
+        m_lastSentFrame = rgb;
+        return true;
+    }
+
+    bool sent = false;
+    if (useDeviceFrame)
+    {
+        DriverProtocol::encodeDeviceFrame(layout, rgb, m_deviceFrameScratch);
+        sent = sendFrameMessage(MessageType::SetDeviceFrame, m_deviceFrameScratch);
+    }
+    else
+    {
+        sent = sendFrameMessage(MessageType::SetLedColors, rgb);
+    }
+    if (!sent)
+    {
+        return false;
+    }
+
+    m_lastSentFrame = rgb;
+    m_lastSentLayout = layout;
+    m_keyframeRequested = false;
+    m_keyframeTimer.start();
+    return true;
+}
+
+void WDLSyncWorker::resetFrameReference()
+{
+    m_linkStats.resetConnection();
+    m_lastSentFrame.clear();
+    m_lastSentLayout.clear();
+    m_keyframeRequested = true;
+    m_keyframeTimer.invalidate();
+    m_rxFramer.clear();
+}
+
+void WDLSyncWorker::handleDriverMessage(DriverProtocol::MessageType type, const DriverProtocol::PayloadView& payload)
+{
+    switch (type)
+    {
+        case DriverProtocol::MessageType::RequestKeyframe:
+            WDLLogger::Log(WDLLogger::Debug, "Driver requested keyframe.");
+            m_keyframeRequested = true;
+            requestFrame();
+            break;
+        case DriverProtocol::MessageType::HelloAck:
+        {
+            DriverProtocol::Capabilities negotiated;
+            if (!negotiated.decode(payload))
+            {
+                WDLLogger::Log(WDLLogger::Warning, "Malformed HelloAck from driver.");
+                break;
+            }
+            // O driver já devolve o conjunto comum; intersectar de novo por segurança
+            m_driverCaps = DriverProtocol::Capabilities::negotiate(DriverProtocol::localCapabilities(), negotiated);
+            m_helloAcked = true;
+            m_keyframeRequested = true; // codificação pode ter mudado
+            requestFrame();
+            WDLLogger::Log(WDLLogger::Info, QString("Driver protocol negotiated: %1").arg(m_driverCaps.describe()));
+            if (m_driverCaps.has(DriverProtocol::TransportSharedMemory))
+            {
+                requestSharedTransport();
+            }
+            publishStatus(true);
+            break;
+        }
+        case DriverProtocol::MessageType::SharedTransportAck:
+            m_sharedTransportActive = m_sharedRing && payload.size >= 1 && payload.data[0] != 0;
+            if (!m_sharedTransportActive)
+            {
+                m_sharedRing.reset();
+            }
+            WDLLogger::Log(WDLLogger::Info, QString("Shared memory transport: %1")
+                            .arg(m_sharedTransportActive ? "active" : "rejected, using socket"));
+            publishStatus(true);
+            break;
+        case DriverProtocol::MessageType::Pong:
+        {
+            // Pong vazio: driver antigo, sem eco do horário
+            qint64 sentNs = 0;
+            qint64 driverNs = 0;
+            if (DriverProtocol::PongStampedMsg::decode(payload, sentNs, driverNs))
+            {
+                m_linkStats.onPong(sentNs, DriverProtocol::presentationClockNs());
+            }
+            break;
+        }
+        case DriverProtocol::MessageType::FrameAck:
+        {
+            quint32 seq = 0;
+            qint64 sentNs = 0;
+            qint64 receivedNs = 0;
+            if (DriverProtocol::FrameAckMsg::decode(payload, seq, sentNs, receivedNs))
+            {
+                m_linkStats.onFrameAck(seq, sentNs, receivedNs);
+            }
+            break;
+        }
+        default:
+            // Demais respostas (StatusResponse) ainda não são usadas
+            break;
+    }
+}
+
+bool WDLSyncWorker::sendFrameMessage(DriverProtocol::MessageType type, const QByteArray& frame)
+{
+    const bool stamped = m_driverCaps.has(DriverProtocol::EncodingTimedFrame);
+    const int size = frame.size() + (stamped ? DriverProtocol::TimedFrameHeaderSize : 0);
+
+    // Respeitar o limite anunciado pelo driver (type + payload)
+    if (static_cast<quint64>(size) + sizeof(quint16) > m_driverCaps.maxFrameSize)
+    {
+        WDLLogger::Log(WDLLogger::Warning, QString("Frame of %1 bytes exceeds driver limit (%2).")
+                        .arg(size).arg(m_driverCaps.maxFrameSize));
+        return false;
+    }
+
+    // Envelope com sequência, horário de envio e instante de apresentação
+    const QByteArray* message = &frame;
+    qint64 seq = DriverSendQueue::NoSequence;
+    if (stamped)
+    {
+        DriverProtocol::FrameStamp stamp;
+        stamp.seq         = m_linkStats.nextSequence();
+        seq               = stamp.seq;
+        stamp.sentNs      = DriverProtocol::presentationClockNs();
+        stamp.presentAtNs = stamp.sentNs;
+        DriverProtocol::encodeTimedFrame(stamp, type, frame.constData(), frame.size(), m_timedFrameScratch);
+        type = DriverProtocol::MessageType::TimedFrame;
+        message = &m_timedFrameScratch;
+    }
+    const QByteArray& payload = *message;
+
+    // Anel compartilhado ativo: publica o frame e envia só o doorbell
+    if (m_sharedTransportActive && m_sharedRing)
+    {
+        const quint64 seq = m_sharedRing->publish(static_cast<quint16>(type), payload.constData(), payload.size());
+        if (seq != 0 && ensureDriverConnection())
+        {
+            m_txBuffer.resize(0);
+            DriverProtocol::FrameDoorbellMsg::packInto(m_txBuffer, seq);
+            return writePacket(m_txBuffer, DriverSendQueue::Lane::Frame);
+        }
+        // Frame maior que o slot: segue pelo socket
+    }
+    return sendMessage(static_cast<quint16>(type), payload, DriverSendQueue::Lane::Frame, seq);
+}
+
+void WDLSyncWorker::sendHello()
+{
+    m_driverCaps = DriverProtocol::Capabilities();
+    m_helloAcked = false;
+
+    DriverProtocol::Capabilities local = DriverProtocol::localCapabilities();
+    if (!m_settings.sharedTransportEnabled)
+    {
+        local.transports &= ~DriverProtocol::TransportSharedMemory;
+    }
+    if (ensureDriverConnection())
+    {
+        m_txBuffer.resize(0);
+        local.packInto(m_txBuffer, DriverProtocol::MessageType::Hello);
+        writePacket(m_txBuffer);
+    }
+    publishStatus(true);
+}
+
+void WDLSyncWorker::onLinkProbe()
+{
+    // Sem reconexão aqui: a sonda só mede uma conexão existente
+    if (!isDriverConnected())
+    {
+        return;
+    }
+
+    sendSchema<DriverProtocol::PingStampedMsg>(DriverProtocol::presentationClockNs());
+    publishStatus();
+
+    if (++m_linkProbes % LinkLogEveryProbes == 0 && m_linkStats.hasSamples())
+    {
+        const RollingWindow::Summary rtt = m_linkStats.rtt();
+        const RollingWindow::Summary frame = m_linkStats.oneWay();
+        WDLLogger::Log(WDLLogger::Info, QString("Driver link: rtt p50/p99/max %1/%2/%3 us, frame latency p50/p99/max %4/%5/%6 us, "
+                                                "%7 frames sent, %8 acked, %9 lost, %10 reordered")
+                        .arg(rtt.p50 / 1000).arg(rtt.p99 / 1000).arg(rtt.max / 1000)
+                        .arg(frame.p50 / 1000).arg(frame.p99 / 1000).arg(frame.max / 1000)
+                        .arg(m_linkStats.framesSent())
+                        .arg(m_linkStats.framesAcked())
+                        .arg(m_linkStats.framesLost())
+                        .arg(m_linkStats.framesReordered()));
+    }
+}
+
+void WDLSyncWorker::requestSharedTransport()
+{
+    releaseSharedTransport();
+    if (!m_settings.sharedTransportEnabled)
+    {
+        return;
+    }
+
+    static quint32 ringCounter = 0;
+    const QString name = QString("OpenRGB_WDL_%1_%2").arg(QCoreApplication::applicationPid()).arg(++ringCounter);
+
+    m_sharedRing.reset(new DriverProtocol::SharedFrameRing);
+    if (!m_sharedRing->create(name, SharedRingSlotCount, SharedRingSlotSize))
+    {
+        WDLLogger::Log(WDLLogger::Warning, QString("Could not create shared frame ring '%1'; using socket.").arg(name));
+        m_sharedRing.reset();
+        return;
+    }
+
+    // Frames seguem pelo socket até o driver confirmar (drivers antigos não respondem)
+    const QByteArray utf8 = name.toUtf8();
+    QByteArray payload(static_cast<int>(sizeof(quint16)), Qt::Uninitialized);
+    qToLittleEndian<quint16>(static_cast<quint16>(utf8.size()), payload.data());
+    payload.append(utf8);
+    sendMessage(static_cast<quint16>(DriverProtocol::MessageType::OpenSharedTransport), payload);
+}
+
+void WDLSyncWorker::releaseSharedTransport()
+{
+    m_sharedTransportActive = false;
+    m_sharedRing.reset();
+}
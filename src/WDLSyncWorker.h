@@ -0,0 +1,401 @@
+#ifndef WDL_SYNC_WORKER_H
+#define WDL_SYNC_WORKER_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QTimer>
+#include <QLocalSocket>
+#include <QScopedPointer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSemaphore>
+#include <QSharedPointer>
+
+#include <atomic>
+#include <vector>
+
+#include "../driver/common/DriverFramer.h"
+#include "../driver/common/DeviceFrame.h"
+#include "../driver/common/SharedFrameRing.h"
+#include "../driver/common/Handshake.h"
+#include "../driver/common/MessageSchema.h"
+#include "../driver/common/FrameTiming.h"
+#include "RGBController.h"
+#include "DriverLinkStats.h"
+#include "DriverSendQueue.h"
+#include "SnapshotBuffer.h"
+#include "WorkStealingPool.h"
+#include "ColorSource.h"
+#include "EffectEngine.h"
+#include "LedSpatialIndex.h"
+#include "ColorCalibration.h"
+#include "AdaptiveScheduler.h"
+
+class ResourceManagerInterface;
+
+// Conexão com o driver, sem esperas bloqueantes
+enum class DriverConnectionState
+{
+    Disconnected, // sem tentativa (antes do start ou após o shutdown)
+    Connecting,   // connectToServer em andamento
+    Connected,
+    Backoff       // aguardando a próxima tentativa
+};
+
+// Estado publicado pelo worker para a UI. Preenchido por inteiro a cada
+// publicação (o buffer reaproveitado contém um snapshot antigo).
+struct SyncStatus
+{
+    // Efeito: válido depois do primeiro tick
+    bool effectKnown = false;
+    int  red   = 0;
+    int  green = 0;
+    int  blue  = 0;
+    quint64 ticks = 0;
+    EffectType      effectType = EffectType::Static;
+    EffectDirection effectDirection = EffectDirection::Forward;
+    QColor  secondary;
+    qint64  renderUs = 0; // último frame renderizado pelo EffectEngine
+    bool    transitionActive = false;
+    quint64 transitions = 0;
+    quint64 transitionFrames = 0;
+
+    // Ritmo dos ticks (AdaptiveScheduler ou intervalo fixo)
+    bool    adaptiveInterval = true;
+    int     intervalMs = 0;       // espaçamento mínimo em vigor
+    AdaptiveScheduler::Limit rateLimit = AdaptiveScheduler::Limit::Floor;
+    QString limitingBus;          // barramento mais caro
+    qint64  tickCostUs = 0;       // média do tick na thread do worker
+    qint64  busCostUs = 0;        // soma dos dispositivos do barramento mais caro
+    double  backoff = 1.0;
+
+    // Fonte da cor
+    QString colorSource;       // ColorSource::describe(), vazio = nenhuma (branco)
+    quint64 sourceChanges = 0; // avisos de mudança recebidos
+
+    // Dirty tracking dos controladores (acumulado na sessão)
+    quint64 deviceUpdates = 0;   // UpdateLEDs enviados
+    quint64 deviceSkips = 0;     // controladores já com as cores do tick
+    quint64 modeSwitches = 0;    // SetCustomMode (início ou troca externa)
+    quint64 framesUnchanged = 0; // frames iguais ao último enviado ao driver
+
+    // Despacho paralelo
+    quint64 deadlineMisses = 0;  // controladores pulados por estourar o prazo do tick
+    quint64 devicesBusy = 0;     // controladores ainda ocupados com um tick anterior
+    quint64 poolSteals = 0;
+
+    // Driver
+    bool    driverConnected = false;
+    DriverConnectionState connectionState = DriverConnectionState::Disconnected;
+    int     reconnectAttempts = 0; // falhas seguidas desde a última conexão
+    int     nextRetryMs = 0;       // em Backoff
+    quint64 sendsDropped = 0;      // envios descartados sem conexão
+    bool    helloAcked = false;
+    bool    sharedTransportActive = false;
+    QString capabilities; // Capabilities::describe() do conjunto negociado
+
+    // Fila de envio (DriverSendQueue)
+    int     sendQueueDepth = 0;
+    qint64  sendQueueBytes = 0;
+    int     sendQueuePeak = 0;
+    quint64 framesCoalesced = 0; // frames substituídos por um mais novo na fila
+
+    // Enlace (DriverLinkStats)
+    bool    hasLinkSamples = false;
+    RollingWindow::Summary rtt;
+    RollingWindow::Summary oneWay;
+    quint64 framesLost = 0;
+    quint64 framesReordered = 0;
+};
+
+// Pipeline de sincronização fora da thread da UI: captura da cor, cálculo,
+// atualização dos controladores do OpenRGB e envio ao driver. Vive em uma
+// QThread própria e é dono do timer de tick, do socket e de todo o estado
+// do protocolo. A UI recebe o estado por um snapshot lock-free publicado
+// no máximo a cada StatusPublishIntervalMs.
+//
+// Ticks são sob demanda: mudança na ColorSource, ajuste do usuário, pedido
+// de keyframe do driver, dispositivos que ficaram para trás ou animação
+// (requestFrame). O intervalo de sincronização é o espaçamento mínimo entre
+// ticks; sem eventos, um tick de manutenção a cada IdleRefreshMs refaz o
+// keyframe e detecta trocas externas de modo. Com o intervalo adaptativo o
+// espaçamento vem do custo medido (AdaptiveScheduler) em vez do fixo.
+class WDLSyncWorker : public QObject
+{
+    Q_OBJECT
+public:
+    struct Settings
+    {
+        bool   syncEnabled = false;
+        int    syncIntervalMs = 100;   // só sem o intervalo adaptativo
+        bool   adaptiveInterval = true;
+        bool   brightnessEnabled = false;
+        double brightness = 1.0; // 0.0 - 1.0
+        bool   sharedTransportEnabled = true;
+        QString colorSource;     // ColorSource::create()
+        EffectParams effect;     // primária e brilho vêm da fonte a cada tick
+        QVector<LedSpatialIndex::DevicePlacement> devicePlacements;
+        QVector<CalibrationProfile> calibrationProfiles;
+        int    transitionMs = 300;  // 0 = troca imediata
+        int    transitionFps = 60;
+    };
+
+    static constexpr int StatusPublishIntervalMs = 250;
+
+    WDLSyncWorker(ResourceManagerInterface* resourceManager, const Settings& settings, QObject* parent = nullptr);
+    ~WDLSyncWorker();
+
+    // Só a thread da UI: snapshot mais recente, ou nullptr se nada mudou
+    // desde a última chamada. Válido até a próxima chamada.
+    const SyncStatus* takeStatus();
+
+    // Executados na thread do worker (QMetaObject::invokeMethod)
+    void start();
+    void shutdown();
+    void setSyncEnabled(bool enabled);
+    void setSyncInterval(int intervalMs);
+    void setAdaptiveInterval(bool enabled);
+    void setBrightnessEnabled(bool enabled);
+    void setBrightness(double value);
+    void setEffect(const EffectParams& params);
+    void setDevicePlacements(const QVector<LedSpatialIndex::DevicePlacement>& placements);
+    void setCalibrationProfiles(const QVector<CalibrationProfile>& profiles);
+    void setTransition(int durationMs, int fps);
+    void setPlatformReady(bool ready); // SO compatível e API LampArray disponível
+    // Lista de dispositivos mudou: cópia tirada pela thread que a alterou.
+    // Chamada bloqueante (BlockingQueuedConnection) a partir da callback do
+    // OpenRGB, que só libera os controladores antigos depois do retorno.
+    void invalidateControllers(const std::vector<RGBController*>& controllers);
+    void requestFrame();               // agenda um tick respeitando o intervalo
+
+private slots:
+    void onSyncTick();
+    void onLinkProbe();
+
+private:
+    ResourceManagerInterface* m_resourceManager;
+    Settings m_settings;
+    bool     m_platformReady = false;
+
+    // Cópia da lista de controladores do OpenRGB. A lista viva é alterada
+    // pela thread de detecção; o worker só usa esta cópia, trocada em
+    // invalidateControllers enquanto a detecção espera.
+    std::vector<RGBController*> m_controllers;
+
+    static constexpr int IdleRefreshMs = 2000;
+
+    QTimer* m_syncTimer = nullptr; // single-shot: próximo tick pedido
+    QTimer* m_idleTimer = nullptr; // tick de manutenção sem eventos
+    QElapsedTimer m_lastTick;
+    quint64 m_ticks = 0;
+
+    // Custo medido: tick na thread do worker (sem a espera pelo pool) e
+    // UpdateLEDs por dispositivo, somado por barramento a cada despacho
+    AdaptiveScheduler m_scheduler { TickDeadlineFraction };
+    qint64 m_dispatchWaitNs = 0;
+
+    ColorSource* m_colorSource = nullptr;
+    quint64      m_sourceChanges = 0;
+    int     m_red   = 0;
+    int     m_green = 0;
+    int     m_blue  = 0;
+
+    // Frame por LED a partir do efeito, sobre o índice espacial refeito a
+    // cada mudança na lista de dispositivos (ou se um tick encontra outro
+    // layout, p. ex. zona redimensionada). Efeitos animados pedem o
+    // próximo tick ao fim de cada um.
+    EffectEngine    m_effects;
+    LedSpatialIndex m_ledIndex;
+    QElapsedTimer   m_effectClock;
+    qint64          m_renderNs = 0;
+    void rebuildLedIndex();
+
+    // Transição suave: mudança de cor ou de efeito mistura o frame exibido
+    // com o novo em ponto fixo, a transitionFps por transitionMs; depois
+    // volta ao ritmo normal (eventos e intervalo de sincronização)
+    bool          m_transitionActive = false;
+    QElapsedTimer m_transitionClock;
+    QByteArray    m_transitionFrom; // frame exibido no início
+    QByteArray    m_renderFrame;    // frame alvo durante a transição
+    quint64       m_transitions = 0;
+    quint64       m_transitionFrames = 0;
+    void startTransition();
+    int  tickIntervalMs() const; // espaçamento mínimo entre ticks agora
+
+    // Último estado aplicado por controlador. SetCustomMode só na primeira
+    // vez ou quando algo externo trocou o modo; UpdateLEDs só quando as
+    // cores do tick diferem do último envio ou do buffer do controlador
+    // (escrita externa). Ponteiros podem ser reaproveitados após um rescan,
+    // então a cada mudança na lista de dispositivos o pool é drenado, os
+    // slots de controladores removidos saem do mapa e os restantes voltam
+    // ao estado inicial. Um slot nunca é recriado para um controlador que
+    // continua na lista: busy vale por controlador, não por geração.
+    //
+    // Enquanto busy, o slot pertence ao job do pool; fora disso, à thread
+    // do worker.
+    struct DeviceSlot
+    {
+        RGBController* controller = nullptr;
+        QString bus;
+        bool modeSet = false;
+        int  mode = -1;
+        bool needsMode = false;
+        bool colorsValid = false;
+        std::vector<RGBColor> colors; // último envio ao dispositivo
+        std::vector<RGBColor> target; // cores do tick em andamento
+        ColorLut lut;                 // perfil do dispositivo + brilho
+        quint64  lutGeneration = 0;
+        std::atomic<qint64> costNs { 0 }; // média de SetCustomMode + UpdateLEDs
+        std::atomic<bool> busy { false };
+
+        void resetApplied(); // como recém-criado, mantendo busy
+    };
+    using DeviceSlotPtr = QSharedPointer<DeviceSlot>;
+    QHash<RGBController*, DeviceSlotPtr> m_devices;
+    DeviceSlotPtr deviceSlot(RGBController* ctrl);
+    static QString busKey(const RGBController* ctrl);
+
+    // Brilho e calibração ficam nas LUTs de cada dispositivo, recompiladas
+    // no próximo tick quando a geração muda. O frame do driver segue sem
+    // elas: o driver aplica o próprio brilho (SetBrightness).
+    quint64 m_lutGeneration = 1;
+    void invalidateLuts() { ++m_lutGeneration; }
+
+    // Atualizações dos dispositivos em paralelo: um job por barramento (os
+    // dispositivos de um mesmo SMBus/I2C seguem em série dentro dele). O
+    // tick espera no máximo até o prazo; o que não começou até lá é pulado
+    // e recebe o frame mais novo no tick seguinte, e um controlador lento
+    // fica ocupado sem segurar os outros nem o tick.
+    //
+    // A série vale por barramento entre ticks, não por controlador: enquanto
+    // o job de um barramento não termina (m_busInFlight), nenhum dispositivo
+    // dele é despachado, nem os que não estavam no job atrasado.
+    static constexpr double TickDeadlineFraction = 0.8; // do intervalo de sincronização
+    struct TickBatch
+    {
+        qint64 deadlineNs = 0;
+        QSemaphore done; // um release por job
+    };
+    QScopedPointer<WorkStealingPool> m_devicePool;
+    QHash<QString, QVector<DeviceSlotPtr>> m_busGroups; // montado a cada tick
+    using BusFlag = QSharedPointer<std::atomic<bool>>;
+    QHash<QString, BusFlag> m_busInFlight; // true do despacho ao fim do job do barramento
+    BusFlag busInFlight(const QString& bus);
+    bool dispatchDevices(const QColor& fallback); // false se algum dispositivo ficou para trás
+    void runDeviceGroup(const TickBatch& batch, const QVector<DeviceSlotPtr>& group, const BusFlag& inFlight);
+    void measureBusCosts();
+    QHash<QString, qint64> m_busCosts; // reutilizado por measureBusCosts
+
+    std::atomic<quint64> m_deviceUpdates { 0 };
+    std::atomic<quint64> m_deviceSkips { 0 };
+    std::atomic<quint64> m_modeSwitches { 0 };
+    std::atomic<quint64> m_deadlineMisses { 0 };
+    std::atomic<quint64> m_devicesBusy { 0 };
+    quint64 m_framesUnchanged = 0;
+
+    SnapshotBuffer<SyncStatus> m_status;
+    QElapsedTimer m_statusTimer;
+    void publishStatus(bool force = false);
+
+    // IPC Client (Named Pipe via QLocalSocket)
+    QScopedPointer<QLocalSocket> m_driverSocket;
+    DriverProtocol::Framer m_rxFramer;
+    QString m_driverServerName = QStringLiteral("OpenRGB_WDL_Driver");
+
+    // Reconexão assíncrona: connectToServer com prazo ConnectTimeoutMs e,
+    // em falha ou queda, nova tentativa com recuo exponencial e jitter
+    // (ReconnectBaseMs dobrando até ReconnectMaxMs, ±25%). Sem conexão, os
+    // envios são descartados na hora em vez de esperar pelo driver.
+    static constexpr int ConnectTimeoutMs = 1000;
+    static constexpr int ReconnectBaseMs  = 250;
+    static constexpr int ReconnectMaxMs   = 10000;
+    DriverConnectionState m_connectionState = DriverConnectionState::Disconnected;
+    QTimer* m_reconnectTimer = nullptr; // prazo da tentativa ou espera do recuo
+    int     m_reconnectAttempts = 0;
+    bool    m_reconnectEnabled = false; // desligado no shutdown
+    quint64 m_sendsDropped = 0;
+
+    void ConnectToVirtualDriver(); // inicia uma tentativa; resultado pelos sinais
+    void DisconnectFromVirtualDriver();
+    bool isDriverConnected() const;
+    void setConnectionState(DriverConnectionState state);
+    void onDriverConnected();
+    void onDriverConnectionLost();
+    void onReconnectTimer();
+
+    // Referência de frame por conexão para SetLedColorsDelta/SetDeviceFrame
+    static constexpr int KeyframeIntervalMs = 2000;
+    QByteArray    m_lastSentFrame;   // último frame conhecido pelo driver
+    QVector<DriverProtocol::DeviceFrameEntry> m_lastSentLayout;
+    QByteArray    m_deltaScratch;    // buffer reutilizado pelo encoder
+    QByteArray    m_deviceFrameScratch;
+
+    // Com TimedFrame negociado cada frame leva sequência, horário de envio e
+    // o instante de apresentação. Frames ao vivo não são pré-renderizados:
+    // apresentação = envio, e o driver os trata como já vencidos (exibe no
+    // próximo tick e continua coalescendo os que se acumulam)
+    QByteArray    m_timedFrameScratch;
+
+    // Latência do enlace: Ping com horário a cada LinkProbeIntervalMs e
+    // resumo no log a cada LinkLogEveryProbes
+    static constexpr int LinkProbeIntervalMs = 1000;
+    static constexpr int LinkLogEveryProbes  = 10;
+    DriverLinkStats m_linkStats;
+    QTimer*         m_linkTimer = nullptr;
+    int             m_linkProbes = 0;
+
+    // Frame endereçado por dispositivo/zona montado a cada tick
+    QVector<DriverProtocol::DeviceFrameEntry> m_frameLayout;
+    QByteArray    m_frameColors;
+    QElapsedTimer m_keyframeTimer;
+    bool          m_keyframeRequested = true;
+
+    // Transporte opcional por memória compartilhada (negociado por conexão)
+    static constexpr quint32 SharedRingSlotCount = 4;
+    static constexpr quint32 SharedRingSlotSize  = 512 * 1024;
+    // Conjunto negociado no Hello/HelloAck; até a resposta (ou com drivers
+    // antigos, que não respondem) vale o padrão legado: full frame via socket
+    DriverProtocol::Capabilities m_driverCaps;
+    bool m_helloAcked = false;
+
+    bool m_sharedTransportActive = false; // driver confirmou SharedTransportAck
+    QScopedPointer<DriverProtocol::SharedFrameRing> m_sharedRing;
+
+    QByteArray m_txBuffer; // pacote de saída reutilizado (sem alocação por mensagem)
+
+    // Saída sem bloquear a thread: escrita conforme o socket drena
+    // (bytesWritten); frames acumulados viram só o mais novo
+    DriverSendQueue m_sendQueue;
+
+    bool ensureDriverConnection();
+    bool writePacket(const QByteArray& packet, DriverSendQueue::Lane lane = DriverSendQueue::Lane::Control,
+                     qint64 seq = DriverSendQueue::NoSequence);
+    bool pumpSendQueue();
+    bool sendMessage(quint16 type, const QByteArray& payload, DriverSendQueue::Lane lane = DriverSendQueue::Lane::Control,
+                     qint64 seq = DriverSendQueue::NoSequence);
+
+    // Mensagens de payload fixo: empacota direto em m_txBuffer via schema
+    template <typename Schema, typename... Args>
+    bool sendSchema(Args... args)
+    {
+        if (!ensureDriverConnection())
+        {
+            return false;
+        }
+        m_txBuffer.resize(0);
+        Schema::packInto(m_txBuffer, args...);
+        return writePacket(m_txBuffer);
+    }
+    bool sendFrameMessage(DriverProtocol::MessageType type, const QByteArray& frame);
+    void sendHello();
+    void sendBrightness();
+    void requestSharedTransport();
+    void releaseSharedTransport();
+    bool sendLedFrame(const QVector<DriverProtocol::DeviceFrameEntry>& layout, const QByteArray& rgb);
+    void resetFrameReference();
+    void handleDriverMessage(DriverProtocol::MessageType type, const DriverProtocol::PayloadView& payload);
+};
+
+#endif // WDL_SYNC_WORKER_H
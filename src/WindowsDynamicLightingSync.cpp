@@ -12,9 +12,8 @@
 #include <QMutexLocker>
 #include <QStandardPaths>
 #include <QDir>
+#include <QColorDialog>
 #include "RGBController.h"
-#include <algorithm>
-#include "../driver/common/DriverProtocol.h"
 #ifdef Q_OS_WIN
 #include <windows.h>
 #include <roapi.h>
@@ -111,10 +110,29 @@ void WindowsDynamicLightingSync::Load(ResourceManagerInterface* resource_manager
         QSettings s("Oraculo", "OpenRGBWindowsDynamicLightingSyncPlugin");
         syncEnabled               = s.value("enableSync", false).toBool();
         isPluginEnabled           = syncEnabled;
-        syncIntervalMs            = s.value("syncIntervalMs", 100).toInt();
+        syncIntervalMs            = qBound(AdaptiveScheduler::FloorMs, s.value("syncIntervalMs", 100).toInt(), 5000);
+        adaptiveInterval          = s.value("adaptiveInterval", true).toBool();
         brightnessOverrideEnabled = s.value("brightnessEnabled", false).toBool();
         brightnessOverride        = s.value("brightness", 1.0).toDouble();
         brightnessMultiplier      = brightnessOverride;
+        sharedTransportEnabled    = s.value("sharedMemoryTransport", true).toBool();
+        colorSourceSpec           = s.value("colorSource", QString()).toString();
+        effectSettings.type       = static_cast<EffectType>(qBound(0, s.value("effect", 0).toInt(), static_cast<int>(EffectType::Gradient)));
+        effectSettings.direction  = static_cast<EffectDirection>(qBound(0, s.value("effectDirection", 0).toInt(), static_cast<int>(EffectDirection::Down)));
+        effectSettings.speed      = qBound(1, s.value("effectSpeed", 5).toInt(), 20) / 10.0;
+        transitionMs              = qBound(0, s.value("transitionMs", 300).toInt(), 5000);
+        transitionFps             = qBound(10, s.value("transitionFps", 60).toInt(), 144);
+        effectSettings.secondary  = QColor(s.value("secondaryColor", QString("#000000")).toString());
+        if (!effectSettings.secondary.isValid())
+        {
+            effectSettings.secondary = Qt::black;
+        }
+        // Fontes de teste (file:, stdin, socket:) sem alterar as preferências
+        const QString envSource = qEnvironmentVariable("WDL_COLOR_SOURCE");
+        if (!envSource.isEmpty())
+        {
+            colorSourceSpec = envSource;
+        }
         WDLLogger::Log(WDLLogger::Debug, QString("Settings loaded: enable=%1, interval=%2, bright_en=%3, bright=%4")
                         .arg(syncEnabled)
                         .arg(syncIntervalMs)
@@ -122,6 +140,8 @@ void WindowsDynamicLightingSync::Load(ResourceManagerInterface* resource_manager
                         .arg(brightnessOverride));
     }
 
+    loadDeviceProfiles();
+
     RMPointer = resource_manager_ptr;
 
     // Registrar callback para mudanças na lista de dispositivos apenas uma vez
@@ -132,15 +152,8 @@ void WindowsDynamicLightingSync::Load(ResourceManagerInterface* resource_manager
         WDLLogger::Log(WDLLogger::Debug, "Registered device list change callback.");
     }
 
-    // Etapa 4 — conectar ao driver via Named Pipe (QLocalSocket)
-    if (ConnectToVirtualDriver())
-    {
-        WDLLogger::Log(WDLLogger::Info, "Connected to driver server.");
-    }
-    else
-    {
-        WDLLogger::Log(WDLLogger::Warning, "Failed to connect to driver server.");
-    }
+    // Etapa 4 — captura, dispositivos e driver na thread de sincronização
+    startSyncWorker();
 }
 
 
@@ -179,6 +192,15 @@ QWidget* WindowsDynamicLightingSync::GetWidget()
     secondaryColorLabel = new QLabel("Cor Secundaria: Verificando...");
     controlLayout->addWidget(secondaryColorLabel);
 
+    driverStatusLabel = new QLabel("Driver: Verificando...");
+    controlLayout->addWidget(driverStatusLabel);
+
+    syncStatsLabel = new QLabel("Atualizações: Verificando...");
+    controlLayout->addWidget(syncStatsLabel);
+
+    syncRateLabel = new QLabel("Taxa: Verificando...");
+    controlLayout->addWidget(syncRateLabel);
+
     mainLayout->addWidget(controlGroupBox);
 
     // 2. Dispositivos
@@ -200,7 +222,7 @@ QWidget* WindowsDynamicLightingSync::GetWidget()
 
     settingsLayout->addWidget(new QLabel("Intervalo de Sincronização (ms):"), 0, 0);
     syncIntervalSpinbox = new QSpinBox();
-    syncIntervalSpinbox->setRange(50, 5000);
+    syncIntervalSpinbox->setRange(AdaptiveScheduler::FloorMs, 5000);
     syncIntervalSpinbox->setValue(100);
     settingsLayout->addWidget(syncIntervalSpinbox, 0, 1);
 
@@ -218,6 +240,42 @@ QWidget* WindowsDynamicLightingSync::GetWidget()
     brightnessLayout->addWidget(brightnessValueLabel);
     settingsLayout->addWidget(brightnessContainer, 2, 0, 1, 2);
 
+    // Ordem dos itens = valores de EffectType / EffectDirection
+    settingsLayout->addWidget(new QLabel("Efeito:"), 3, 0);
+    effectCombo = new QComboBox();
+    effectCombo->addItems({ "Estático", "Respiração", "Arco-íris", "Onda", "Roda", "Gradiente" });
+    settingsLayout->addWidget(effectCombo, 3, 1);
+
+    settingsLayout->addWidget(new QLabel("Direção:"), 4, 0);
+    directionCombo = new QComboBox();
+    directionCombo->addItems({ "Para frente", "Para trás", "Para fora", "Para dentro", "Para cima", "Para baixo" });
+    settingsLayout->addWidget(directionCombo, 4, 1);
+
+    settingsLayout->addWidget(new QLabel("Velocidade do efeito:"), 5, 0);
+    effectSpeedSlider = new QSlider(Qt::Horizontal);
+    effectSpeedSlider->setRange(1, 20); // décimos de ciclo por segundo
+    settingsLayout->addWidget(effectSpeedSlider, 5, 1);
+
+    secondaryColorButton = new QPushButton("Cor secundária...");
+    settingsLayout->addWidget(secondaryColorButton, 6, 0, 1, 2);
+
+    // Só durante a transição os ticks seguem a taxa abaixo
+    settingsLayout->addWidget(new QLabel("Transição de cor (ms):"), 7, 0);
+    transitionSpinbox = new QSpinBox();
+    transitionSpinbox->setRange(0, 5000);
+    transitionSpinbox->setSingleStep(50);
+    transitionSpinbox->setSpecialValueText("Desligada");
+    settingsLayout->addWidget(transitionSpinbox, 7, 1);
+
+    settingsLayout->addWidget(new QLabel("Taxa da transição (fps):"), 8, 0);
+    transitionFpsSpinbox = new QSpinBox();
+    transitionFpsSpinbox->setRange(10, 144);
+    settingsLayout->addWidget(transitionFpsSpinbox, 8, 1);
+
+    // Ligado, o intervalo acima é ignorado: a taxa vem do custo medido
+    adaptiveIntervalCheckbox = new QCheckBox("Intervalo adaptativo (pelo custo medido)");
+    settingsLayout->addWidget(adaptiveIntervalCheckbox, 9, 0, 1, 2);
+
     mainLayout->addWidget(settingsGroupBox);
 
     // 4. Informações do Sistema
@@ -251,16 +309,34 @@ QWidget* WindowsDynamicLightingSync::GetWidget()
     // Aplicar valores persistidos nas preferências antes de conectar sinais
     enableSyncCheckbox->setChecked(syncEnabled);
     syncIntervalSpinbox->setValue(syncIntervalMs);
+    syncIntervalSpinbox->setEnabled(!adaptiveInterval);
+    adaptiveIntervalCheckbox->setChecked(adaptiveInterval);
     enableBrightnessCheckbox->setChecked(brightnessOverrideEnabled);
     brightnessSlider->setValue(static_cast<int>(qRound(brightnessOverride * 10.0)));
     brightnessValueLabel->setText(QString::number(brightnessOverride, 'f', 1));
     brightnessContainer->setEnabled(enableBrightnessCheckbox->isChecked());
+    effectCombo->setCurrentIndex(static_cast<int>(effectSettings.type));
+    directionCombo->setCurrentIndex(static_cast<int>(effectSettings.direction));
+    directionCombo->setEnabled(EffectEngine::usesDirection(effectSettings.type));
+    effectSpeedSlider->setValue(qRound(effectSettings.speed * 10.0));
+    transitionSpinbox->setValue(transitionMs);
+    transitionFpsSpinbox->setValue(transitionFps);
+    transitionFpsSpinbox->setEnabled(transitionMs > 0);
+    effectSpeedSlider->setEnabled(EffectEngine::isAnimated(effectSettings.type));
+    secondaryColorButton->setEnabled(EffectEngine::usesSecondary(effectSettings.type));
 
     // Conectar sinais aos slots (após configurar valores iniciais)
     connect(enableSyncCheckbox, &QCheckBox::toggled, this, &WindowsDynamicLightingSync::onEnableSyncCheckboxToggled);
     connect(syncIntervalSpinbox, QOverload<int>::of(&QSpinBox::valueChanged), this, &WindowsDynamicLightingSync::onSyncIntervalSpinboxValueChanged);
+    connect(adaptiveIntervalCheckbox, &QCheckBox::toggled, this, &WindowsDynamicLightingSync::onAdaptiveIntervalCheckboxToggled);
     connect(enableBrightnessCheckbox, &QCheckBox::toggled, this, &WindowsDynamicLightingSync::onEnableBrightnessCheckboxToggled);
     connect(brightnessSlider, &QSlider::valueChanged, this, &WindowsDynamicLightingSync::onBrightnessSliderValueChanged);
+    connect(effectCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &WindowsDynamicLightingSync::onEffectSettingsChanged);
+    connect(directionCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &WindowsDynamicLightingSync::onEffectSettingsChanged);
+    connect(effectSpeedSlider, &QSlider::valueChanged, this, &WindowsDynamicLightingSync::onEffectSettingsChanged);
+    connect(secondaryColorButton, &QPushButton::clicked, this, &WindowsDynamicLightingSync::onSecondaryColorButtonClicked);
+    connect(transitionSpinbox, QOverload<int>::of(&QSpinBox::valueChanged), this, &WindowsDynamicLightingSync::onTransitionSettingsChanged);
+    connect(transitionFpsSpinbox, QOverload<int>::of(&QSpinBox::valueChanged), this, &WindowsDynamicLightingSync::onTransitionSettingsChanged);
     connect(updateButton, &QPushButton::clicked, this, &WindowsDynamicLightingSync::onUpdateButtonClicked);
     connect(reloadButton, &QPushButton::clicked, this, &WindowsDynamicLightingSync::onReloadButtonClicked);
 
@@ -270,6 +346,7 @@ QWidget* WindowsDynamicLightingSync::GetWidget()
 
     // Renderizar lista de dispositivos na primeira abertura (wrappers)
     UpdateDeviceList();
+    onStatusRefresh();
 
     return mainWidget;
 }
@@ -317,8 +394,8 @@ void WindowsDynamicLightingSync::Unload()
         WDLLogger::Log(WDLLogger::Debug, "Unregistered device list change callback.");
     }
 
-    // Etapa 1.2.1 — encerrar conexão com driver virtual (stub)
-    DisconnectFromVirtualDriver();
+    // Etapa 1.2.1 — encerrar sincronização e conexão com driver virtual
+    stopSyncWorker();
 }
 
 WindowsDynamicLightingSync::WindowsDynamicLightingSync() : mainWidget(nullptr)
@@ -327,13 +404,15 @@ WindowsDynamicLightingSync::WindowsDynamicLightingSync() : mainWidget(nullptr)
     // Inicializar flags de estado
     isWindowsCompatible = false;
     isLampArrayApiAvailable = false;
-    syncTimer = new QTimer(this);
-    connect(syncTimer, &QTimer::timeout, this, &WindowsDynamicLightingSync::onSyncTick);
+
+    m_statusTimer = new QTimer(this);
+    connect(m_statusTimer, &QTimer::timeout, this, &WindowsDynamicLightingSync::onStatusRefresh);
 }
 
 WindowsDynamicLightingSync::~WindowsDynamicLightingSync()
 {
      WDLLogger::Log(WDLLogger::Debug, "Destructor.");
+     stopSyncWorker();
 }
 
 void WindowsDynamicLightingSync::onEnableSyncCheckboxToggled(bool checked)
@@ -341,11 +420,7 @@ void WindowsDynamicLightingSync::onEnableSyncCheckboxToggled(bool checked)
     // Atualiza estado e timer
     syncEnabled = checked;
     isPluginEnabled = checked; // manter espelhado com Etapa 1.2.1
-    if (syncEnabled) {
-        syncTimer->start(syncIntervalMs);
-    } else {
-        syncTimer->stop();
-    }
+    postToSyncWorker([checked](WDLSyncWorker* worker) { worker->setSyncEnabled(checked); });
     WDLLogger::Log(WDLLogger::Info, QString("Enable Sync: %1").arg(checked));
 
     // Persistir
@@ -357,9 +432,7 @@ void WindowsDynamicLightingSync::onSyncIntervalSpinboxValueChanged(int value)
 {
     // Ajusta intervalo
     syncIntervalMs = value;
-    if (syncEnabled && syncTimer->isActive()) {
-        syncTimer->start(syncIntervalMs);
-    }
+    postToSyncWorker([value](WDLSyncWorker* worker) { worker->setSyncInterval(value); });
     WDLLogger::Log(WDLLogger::Debug, QString("Sync interval changed: %1 ms").arg(value));
 
     // Persistir
@@ -367,6 +440,18 @@ void WindowsDynamicLightingSync::onSyncIntervalSpinboxValueChanged(int value)
     s.setValue("syncIntervalMs", syncIntervalMs);
 }
 
+void WindowsDynamicLightingSync::onAdaptiveIntervalCheckboxToggled(bool checked)
+{
+    adaptiveInterval = checked;
+    syncIntervalSpinbox->setEnabled(!checked);
+    postToSyncWorker([checked](WDLSyncWorker* worker) { worker->setAdaptiveInterval(checked); });
+    WDLLogger::Log(WDLLogger::Debug, QString("Adaptive sync interval: %1").arg(checked));
+
+    // Persistir
+    QSettings s("Oraculo", "OpenRGBWindowsDynamicLightingSyncPlugin");
+    s.setValue("adaptiveInterval", adaptiveInterval);
+}
+
 void WindowsDynamicLightingSync::onEnableBrightnessCheckboxToggled(bool checked)
 {
     // Atualiza estado e UI
@@ -374,15 +459,8 @@ void WindowsDynamicLightingSync::onEnableBrightnessCheckboxToggled(bool checked)
     WDLLogger::Log(WDLLogger::Debug, QString("Brightness override toggled: %1").arg(checked));
     brightnessContainer->setEnabled(checked);
 
-    // Enviar brightness atual ao driver
-    {
-        float value = checked ? static_cast<float>(brightnessOverride) : 1.0f;
-        QByteArray payload;
-        QDataStream ds(&payload, QIODevice::WriteOnly);
-        ds.setByteOrder(QDataStream::LittleEndian);
-        ds << value;
-        sendMessage(static_cast<quint16>(DriverProtocol::MessageType::SetBrightness), payload);
-    }
+    // Worker aplica no próximo tick e envia o brilho atual ao driver
+    postToSyncWorker([checked](WDLSyncWorker* worker) { worker->setBrightnessEnabled(checked); });
 
     // Persistir
     QSettings s("Oraculo", "OpenRGBWindowsDynamicLightingSyncPlugin");
@@ -397,91 +475,72 @@ void WindowsDynamicLightingSync::onBrightnessSliderValueChanged(int value)
     brightnessValueLabel->setText(QString::number(brightnessOverride, 'f', 1));
     WDLLogger::Log(WDLLogger::Debug, QString("Brightness override value: %1").arg(brightnessOverride));
 
-    // Enviar novo brilho ao driver (se controle estiver habilitado)
-    if (brightnessOverrideEnabled) {
-        float fval = static_cast<float>(brightnessOverride);
-        QByteArray payload;
-        QDataStream ds(&payload, QIODevice::WriteOnly);
-        ds.setByteOrder(QDataStream::LittleEndian);
-        ds << fval;
-        sendMessage(static_cast<quint16>(DriverProtocol::MessageType::SetBrightness), payload);
-    }
+    // Worker envia o novo brilho ao driver (se controle estiver habilitado)
+    const double brightness = brightnessOverride;
+    postToSyncWorker([brightness](WDLSyncWorker* worker) { worker->setBrightness(brightness); });
 
     // Persistir
     QSettings s("Oraculo", "OpenRGBWindowsDynamicLightingSyncPlugin");
     s.setValue("brightness", brightnessOverride);
 }
 
-void WindowsDynamicLightingSync::onSyncTick()
+void WindowsDynamicLightingSync::onEffectSettingsChanged()
 {
-    if (!syncEnabled) return;
-    if (!RMPointer) return;
+    effectSettings.type      = static_cast<EffectType>(effectCombo->currentIndex());
+    effectSettings.direction = static_cast<EffectDirection>(directionCombo->currentIndex());
+    effectSettings.speed     = effectSpeedSlider->value() / 10.0;
+
+    directionCombo->setEnabled(EffectEngine::usesDirection(effectSettings.type));
+    effectSpeedSlider->setEnabled(EffectEngine::isAnimated(effectSettings.type));
+    secondaryColorButton->setEnabled(EffectEngine::usesSecondary(effectSettings.type));
+    applyEffectSettings();
+}
 
-    // Só sincroniza se o SO for compatível e a API estiver disponível
-    if (!isWindowsCompatible || !isLampArrayApiAvailable) {
-        WDLLogger::Log(WDLLogger::Warning, "Sync skipped: OS or API not compatible/available.");
+void WindowsDynamicLightingSync::onSecondaryColorButtonClicked()
+{
+    const QColor color = QColorDialog::getColor(effectSettings.secondary, mainWidget, "Cor secundária");
+    if (!color.isValid())
+    {
         return;
     }
+    effectSettings.secondary = color;
+    applyEffectSettings();
+}
 
-    // 1) Capturar cor de acentuação do Windows (DWM ColorizationColor)
-    QColor accentColorQt(255, 255, 255); // fallback branco
-#ifdef Q_OS_WIN
-    {
-        QSettings settings("HKEY_CURRENT_USER\\Software\\Microsoft\\Windows\\DWM", QSettings::NativeFormat);
-        QVariant v = settings.value("ColorizationColor");
-        if (v.isValid()) {
-            bool ok = false;
-            quint32 argb = v.toUInt(&ok);
-            if (ok) {
-                // Interpreta como 0xAARRGGBB
-                int a = (argb >> 24) & 0xFF;
-                int r = (argb >> 16) & 0xFF;
-                int g = (argb >> 8)  & 0xFF;
-                int b = (argb)       & 0xFF;
-                Q_UNUSED(a);
-                accentColorQt = QColor(r, g, b);
-            }
-        }
-    }
-#endif
+void WindowsDynamicLightingSync::onTransitionSettingsChanged()
+{
+    transitionMs  = transitionSpinbox->value();
+    transitionFps = transitionFpsSpinbox->value();
+    transitionFpsSpinbox->setEnabled(transitionMs > 0);
+    WDLLogger::Log(WDLLogger::Debug, QString("Transition changed: %1 ms at %2 fps").arg(transitionMs).arg(transitionFps));
 
-    // 2) Aplica brilho (se habilitado)
-    double factor = brightnessOverrideEnabled ? std::clamp(brightnessOverride, 0.0, 1.0) : 1.0;
-    int r = static_cast<int>(accentColorQt.red()   * factor);
-    int g = static_cast<int>(accentColorQt.green() * factor);
-    int b = static_cast<int>(accentColorQt.blue()  * factor);
+    const int duration = transitionMs;
+    const int fps = transitionFps;
+    postToSyncWorker([duration, fps](WDLSyncWorker* worker) { worker->setTransition(duration, fps); });
 
-    // 3) Atualiza rótulos de status do efeito
-    if (currentEffectLabel)      currentEffectLabel->setText("Efeito atual: Estático (Accent)");
-    if (directionEffectLabel)    directionEffectLabel->setText("Direção: N/A");
-    if (primaryColorLabel)       primaryColorLabel->setText(QString("Cor Principal: R%1 G%2 B%3").arg(r).arg(g).arg(b));
-    if (secondaryColorLabel)     secondaryColorLabel->setText("Cor Secundaria: N/A");
+    // Persistir
+    QSettings s("Oraculo", "OpenRGBWindowsDynamicLightingSyncPlugin");
+    s.setValue("transitionMs", transitionMs);
+    s.setValue("transitionFps", transitionFps);
+}
 
-    // 4) Empacota para RGBColor do OpenRGB e aplica em todos controladores
-    RGBColor orColor = ToRGBColor(static_cast<unsigned char>(r), static_cast<unsigned char>(g), static_cast<unsigned char>(b));
+void WindowsDynamicLightingSync::applyEffectSettings()
+{
+    WDLLogger::Log(WDLLogger::Debug, QString("Effect changed: type=%1, direction=%2, speed=%3, secondary=%4")
+                    .arg(static_cast<int>(effectSettings.type))
+                    .arg(static_cast<int>(effectSettings.direction))
+                    .arg(effectSettings.speed)
+                    .arg(effectSettings.secondary.name()));
 
-    std::vector<RGBController*>& controllers = RMPointer->GetRGBControllers();
-    for (RGBController* ctrl : controllers)
-    {
-        if (!ctrl) continue;
-        // Define modo custom para garantir controle direto
-        ctrl->SetCustomMode();
-        // Define todas as LEDs com a cor
-        ctrl->SetAllLEDs(orColor);
-        // Envia atualização ao dispositivo
-        ctrl->UpdateLEDs();
-    }
+    const EffectParams params = effectSettings;
+    postToSyncWorker([params](WDLSyncWorker* worker) { worker->setEffect(params); });
 
-    // 5) Enviar cor ao driver virtual
-    {
-        QByteArray payload;
-        payload.append(static_cast<char>(r & 0xFF));
-        payload.append(static_cast<char>(g & 0xFF));
-        payload.append(static_cast<char>(b & 0xFF));
-        if (!sendMessage(static_cast<quint16>(DriverProtocol::MessageType::SetLedColors), payload)) {
-            WDLLogger::Log(WDLLogger::Warning, "Failed to send SetLedColors to driver.");
-        }
-    }
+    // Persistir
+    QSettings s("Oraculo", "OpenRGBWindowsDynamicLightingSyncPlugin");
+    s.setValue("effect", static_cast<int>(effectSettings.type));
+    s.setValue("effectDirection", static_cast<int>(effectSettings.direction));
+    s.setValue("effectSpeed", qRound(effectSettings.speed * 10.0));
+    s.setValue("secondaryColor", effectSettings.secondary.name());
 }
 
 void WindowsDynamicLightingSync::onUpdateButtonClicked()
@@ -500,14 +559,74 @@ void WindowsDynamicLightingSync::onReloadButtonClicked()
     refreshUiStatus();
     refreshDeviceList();
 
+    // Posições e calibração editadas nas preferências valem sem reiniciar
+    loadDeviceProfiles();
+
     // Reinicia timer se necessário
-    if (syncEnabled) {
-        syncTimer->start(syncIntervalMs);
-    }
+    const bool ready = isPlatformReady();
+    const int interval = syncIntervalMs;
+    const QVector<LedSpatialIndex::DevicePlacement> placements = devicePlacements;
+    const QVector<CalibrationProfile> profiles = calibrationProfiles;
+    postToSyncWorker([ready, interval, placements, profiles](WDLSyncWorker* worker) {
+        worker->setPlatformReady(ready);
+        worker->setSyncInterval(interval);
+        worker->setDevicePlacements(placements);
+        worker->setCalibrationProfiles(profiles);
+    });
 }
 
 // --- Auxiliares internos ----------------------------------------------------
 
+void WindowsDynamicLightingSync::loadDeviceProfiles()
+{
+    QSettings s("Oraculo", "OpenRGBWindowsDynamicLightingSyncPlugin");
+
+    // Posição dos dispositivos no canvas dos efeitos (unidades: 1 = um
+    // dispositivo automático); sem entrada, lado a lado na ordem do OpenRGB
+    const int placements = s.beginReadArray("devicePlacement");
+    devicePlacements.clear();
+    for (int i = 0; i < placements; ++i)
+    {
+        s.setArrayIndex(i);
+        LedSpatialIndex::DevicePlacement p;
+        p.device   = s.value("device").toString();
+        p.location = s.value("location").toString();
+        p.rect     = QRectF(s.value("x", 0.0).toDouble(), s.value("y", 0.0).toDouble(),
+                            s.value("width", 1.0).toDouble(), s.value("height", 1.0).toDouble());
+        if (!p.device.isEmpty() && p.rect.isValid())
+        {
+            devicePlacements.append(p);
+        }
+    }
+    s.endArray();
+
+    // Calibração por dispositivo; entrada sem "device" vale para os demais
+    const int profiles = s.beginReadArray("calibration");
+    calibrationProfiles.clear();
+    for (int i = 0; i < profiles; ++i)
+    {
+        s.setArrayIndex(i);
+        CalibrationProfile p;
+        p.device   = s.value("device").toString();
+        p.location = s.value("location").toString();
+        p.gamma    = s.value("gamma", 1.0).toDouble();
+        p.gain[0]  = s.value("gainRed", 1.0).toDouble();
+        p.gain[1]  = s.value("gainGreen", 1.0).toDouble();
+        p.gain[2]  = s.value("gainBlue", 1.0).toDouble();
+        const QColor white(s.value("white", QString("#ffffff")).toString());
+        if (white.isValid())
+        {
+            p.white = white;
+        }
+        calibrationProfiles.append(p);
+    }
+    s.endArray();
+
+    WDLLogger::Log(WDLLogger::Debug, QString("Device profiles loaded: %1 placements, %2 calibration profiles")
+                    .arg(devicePlacements.size())
+                    .arg(calibrationProfiles.size()));
+}
+
 void WindowsDynamicLightingSync::initializeSystemInfo()
 {
     const QOperatingSystemVersion v = QOperatingSystemVersion::current();
@@ -632,6 +751,25 @@ void WindowsDynamicLightingSync::DeviceListChangedCallback(void* arg)
     WindowsDynamicLightingSync* self = reinterpret_cast<WindowsDynamicLightingSync*>(arg);
     if (!self) return;
 
+    // Controladores podem ter sido recriados: descartar o estado aplicado.
+    // Síncrono: o OpenRGB libera os controladores removidos logo depois do
+    // retorno, e o worker não pode estar no meio de um tick com a lista
+    // antiga. A cópia é tirada aqui, na thread que alterou a lista.
+    if (WDLSyncWorker* worker = self->m_syncWorker)
+    {
+        const std::vector<RGBController*> controllers = RMPointer->GetRGBControllers();
+        if (QThread::currentThread() == worker->thread())
+        {
+            worker->invalidateControllers(controllers);
+        }
+        else
+        {
+            QMetaObject::invokeMethod(worker, [worker, controllers]() {
+                worker->invalidateControllers(controllers);
+            }, Qt::BlockingQueuedConnection);
+        }
+    }
+
     // Esta callback pode ser chamada de thread diferente; para segurança, enviar ao thread da UI
     if (self->mainWidget)
     {
@@ -657,6 +795,9 @@ void WindowsDynamicLightingSync::CheckDynamicLightingAvailability()
 {
     // Espelha estado em membro interno
     isDynamicLightingAvailable = isLampArrayApiAvailable;
+
+    const bool ready = isPlatformReady();
+    postToSyncWorker([ready](WDLSyncWorker* worker) { worker->setPlatformReady(ready); });
 }
 
 void WindowsDynamicLightingSync::UpdateDeviceList()
@@ -664,78 +805,211 @@ void WindowsDynamicLightingSync::UpdateDeviceList()
     refreshDeviceList();
 }
 
-bool WindowsDynamicLightingSync::ConnectToVirtualDriver()
+// ---------------- Thread de sincronização ----------------------------------
+
+bool WindowsDynamicLightingSync::isPlatformReady() const
+{
+    return isWindowsCompatible && isLampArrayApiAvailable;
+}
+
+void WindowsDynamicLightingSync::startSyncWorker()
 {
-    // Conecta ao servidor do driver via QLocalSocket
-    if (!m_driverSocket)
+    if (m_syncWorker)
     {
-        m_driverSocket.reset(new QLocalSocket(this));
-        connect(m_driverSocket.data(), &QLocalSocket::readyRead, this, [this]{
-            m_rxBuffer += m_driverSocket->readAll();
-            // No momento apenas consome/descarta; futura lógica de protocolo pode ser adicionada aqui
-            m_rxBuffer.clear();
-        });
-        connect(m_driverSocket.data(), &QLocalSocket::disconnected, this, [this]{
-            WDLLogger::Log(WDLLogger::Warning, "Driver socket disconnected.");
-        });
-        connect(m_driverSocket.data(), QOverload<QLocalSocket::LocalSocketError>::of(&QLocalSocket::errorOccurred), this, [this](QLocalSocket::LocalSocketError code){
-            WDLLogger::Log(WDLLogger::Error, QString("Driver socket error: %1").arg(static_cast<int>(code)));
-        });
+        return;
     }
 
-    if (m_driverSocket->state() == QLocalSocket::ConnectedState)
-        return true;
+    WDLSyncWorker::Settings settings;
+    settings.syncEnabled            = syncEnabled;
+    settings.syncIntervalMs         = syncIntervalMs;
+    settings.adaptiveInterval       = adaptiveInterval;
+    settings.brightnessEnabled      = brightnessOverrideEnabled;
+    settings.brightness             = brightnessOverride;
+    settings.sharedTransportEnabled = sharedTransportEnabled;
+    settings.colorSource            = colorSourceSpec;
+    settings.effect                 = effectSettings;
+    settings.devicePlacements       = devicePlacements;
+    settings.calibrationProfiles    = calibrationProfiles;
+    settings.transitionMs           = transitionMs;
+    settings.transitionFps          = transitionFps;
+
+    m_syncWorker = new WDLSyncWorker(RMPointer, settings);
+    m_syncWorker->setPlatformReady(isPlatformReady());
+
+    m_syncThread = new QThread;
+    m_syncThread->setObjectName("WDL Sync");
+    m_syncWorker->moveToThread(m_syncThread);
+    WDLSyncWorker* worker = m_syncWorker;
+    connect(m_syncThread, &QThread::started, worker, [worker]() { worker->start(); });
+    m_syncThread->start();
+
+    m_statusTimer->start(StatusRefreshIntervalMs);
+    WDLLogger::Log(WDLLogger::Debug, "Sync worker thread started.");
+}
 
-    m_driverSocket->connectToServer(m_driverServerName);
-    if (!m_driverSocket->waitForConnected(500))
+void WindowsDynamicLightingSync::stopSyncWorker()
+{
+    if (!m_syncWorker)
     {
-        WDLLogger::Log(WDLLogger::Warning, QString("Failed to connect to driver server '%1'.").arg(m_driverServerName));
-        return false;
+        return;
     }
 
-    WDLLogger::Log(WDLLogger::Info, QString("Connected to driver server '%1'.").arg(m_driverServerName));
-    return true;
+    m_statusTimer->stop();
+
+    // Timers e socket pertencem à thread do worker: encerrados lá antes do quit
+    WDLSyncWorker* worker = m_syncWorker;
+    QThread* home = thread();
+    QMetaObject::invokeMethod(worker, [worker, home]() {
+        worker->shutdown();
+        worker->moveToThread(home); // destruído na thread da UI
+    }, Qt::BlockingQueuedConnection);
+    m_syncThread->quit();
+    m_syncThread->wait();
+
+    delete m_syncWorker;
+    m_syncWorker = nullptr;
+    delete m_syncThread;
+    m_syncThread = nullptr;
+    WDLLogger::Log(WDLLogger::Debug, "Sync worker thread stopped.");
 }
 
-void WindowsDynamicLightingSync::DisconnectFromVirtualDriver()
+static QString effectName(EffectType type)
 {
-    if (m_driverSocket)
+    switch (type)
     {
-        if (m_driverSocket->state() == QLocalSocket::ConnectedState)
-        {
-            m_driverSocket->disconnectFromServer();
-            m_driverSocket->waitForDisconnected(200);
-        }
-        m_driverSocket.reset();
+        case EffectType::Breathing: return "Respiração";
+        case EffectType::Rainbow:   return "Arco-íris";
+        case EffectType::Wave:      return "Onda";
+        case EffectType::Wheel:     return "Roda";
+        case EffectType::Gradient:  return "Gradiente";
+        case EffectType::Static:
+        default:                    return "Estático";
     }
 }
 
-bool WindowsDynamicLightingSync::sendMessage(quint16 type, const QByteArray& payload)
+// Motivo da taxa escolhida pelo AdaptiveScheduler
+static QString rateLimitReason(const SyncStatus& status)
 {
-    // Ensure socket is connected
-    if (!m_driverSocket || m_driverSocket->state() != QLocalSocket::ConnectedState)
+    switch (status.rateLimit)
     {
-        if (!ConnectToVirtualDriver())
-        {
-            WDLLogger::Log(WDLLogger::Error, "sendMessage: driver connection not available.");
-            return false;
-        }
+    case AdaptiveScheduler::Limit::Floor:   return "taxa máxima";
+    case AdaptiveScheduler::Limit::Cpu:     return QString("custo do tick: %1 µs").arg(status.tickCostUs);
+    case AdaptiveScheduler::Limit::Device:  return QString("barramento mais lento '%1': %2 µs").arg(status.limitingBus).arg(status.busCostUs);
+    case AdaptiveScheduler::Limit::Backoff: return QString("recuo por atrasos (x%1)").arg(status.backoff, 0, 'f', 1);
     }
+    return QString();
+}
 
-    const QByteArray packet = DriverProtocol::pack(static_cast<DriverProtocol::MessageType>(type), payload);
-    const qint64 written = m_driverSocket->write(packet);
-    if (written < 0)
+static QString directionName(EffectDirection direction)
+{
+    switch (direction)
     {
-        WDLLogger::Log(WDLLogger::Error, QString("sendMessage: write failed (%1)").arg(m_driverSocket->errorString()));
-        return false;
+        case EffectDirection::Reverse: return "Para trás";
+        case EffectDirection::Outward: return "Para fora";
+        case EffectDirection::Inward:  return "Para dentro";
+        case EffectDirection::Up:      return "Para cima";
+        case EffectDirection::Down:    return "Para baixo";
+        case EffectDirection::Forward:
+        default:                       return "Para frente";
     }
-    if (written != packet.size())
+}
+
+static QString describeLinkStats(const SyncStatus& status)
+{
+    const auto ms = [](qint64 ns) { return QString::number(static_cast<double>(ns) / 1e6, 'f', 2); };
+    const RollingWindow::Summary& rtt = status.rtt;
+    const RollingWindow::Summary& frame = status.oneWay;
+    return QString("RTT p50 %1 / p99 %2 / máx %3 ms · frame p50 %4 / p99 %5 / máx %6 ms · perdidos %7, fora de ordem %8")
+        .arg(ms(rtt.p50)).arg(ms(rtt.p99)).arg(ms(rtt.max))
+        .arg(ms(frame.p50)).arg(ms(frame.p99)).arg(ms(frame.max))
+        .arg(status.framesLost)
+        .arg(status.framesReordered);
+}
+
+void WindowsDynamicLightingSync::onStatusRefresh()
+{
+    // Sem widget o snapshot fica pendente para a primeira abertura
+    if (!mainWidget || !m_syncWorker)
     {
-        WDLLogger::Log(WDLLogger::Warning, QString("sendMessage: partial write (%1/%2 bytes)").arg(written).arg(packet.size()));
+        return;
+    }
+    const SyncStatus* status = m_syncWorker->takeStatus();
+    if (!status)
+    {
+        return;
     }
 
-    m_driverSocket->flush();
-    m_driverSocket->waitForBytesWritten(20);
-    return written > 0;
+    if (status->effectKnown)
+    {
+        currentEffectLabel->setText(QString("Efeito atual: %1").arg(effectName(status->effectType)));
+        directionEffectLabel->setText(QString("Direção: %1").arg(EffectEngine::usesDirection(status->effectType)
+                                                                 ? directionName(status->effectDirection) : QString("N/A")));
+        primaryColorLabel->setText(QString("Cor Principal: R%1 G%2 B%3").arg(status->red).arg(status->green).arg(status->blue));
+        secondaryColorLabel->setText(EffectEngine::usesSecondary(status->effectType)
+                                         ? QString("Cor Secundaria: R%1 G%2 B%3").arg(status->secondary.red())
+                                               .arg(status->secondary.green()).arg(status->secondary.blue())
+                                         : QString("Cor Secundaria: N/A"));
+        syncStatsLabel->setText(QString("Fonte de cor: %8 · mudanças: %9 · ticks: %10 · render: %11 µs\n"
+                                        "Transições: %12%13 (%14 frames)\n"
+                                        "Atualizações: %1 enviadas, %2 sem mudança · trocas de modo: %3 · frames repetidos não enviados: %4\n"
+                                        "Fora do prazo do tick: %5 · ocupados: %6 · roubos de tarefa: %7")
+                                    .arg(status->deviceUpdates)
+                                    .arg(status->deviceSkips)
+                                    .arg(status->modeSwitches)
+                                    .arg(status->framesUnchanged)
+                                    .arg(status->deadlineMisses)
+                                    .arg(status->devicesBusy)
+                                    .arg(status->poolSteals)
+                                    .arg(status->colorSource.isEmpty() ? QString("nenhuma (branco)") : status->colorSource)
+                                    .arg(status->sourceChanges)
+                                    .arg(status->ticks)
+                                    .arg(status->renderUs)
+                                    .arg(status->transitions)
+                                    .arg(status->transitionActive ? QString(", em andamento") : QString())
+                                    .arg(status->transitionFrames));
+    }
+
+    const QString rate = QString("Taxa: até %1 Hz (%2 ms)").arg(1000.0 / qMax(1, status->intervalMs), 0, 'f', 0).arg(status->intervalMs);
+    syncRateLabel->setText(status->adaptiveInterval
+                               ? QString("%1 · adaptativa, %2").arg(rate, rateLimitReason(*status))
+                               : QString("%1 · fixa").arg(rate));
+
+    QString text;
+    if (status->connectionState == DriverConnectionState::Connecting)
+    {
+        text = status->reconnectAttempts > 0
+                   ? QString("Driver: Conectando (tentativa %1)...").arg(status->reconnectAttempts + 1)
+                   : QString("Driver: Conectando...");
+    }
+    else if (status->connectionState == DriverConnectionState::Backoff)
+    {
+        text = QString("Driver: Desconectado · nova tentativa em %1 s (%2 falhas) · envios descartados: %3")
+                   .arg(status->nextRetryMs / 1000.0, 0, 'f', 1)
+                   .arg(status->reconnectAttempts)
+                   .arg(status->sendsDropped);
+    }
+    else if (!status->driverConnected)
+    {
+        text = "Driver: Desconectado";
+    }
+    else if (!status->helloAcked)
+    {
+        text = "Driver: Conectado (protocolo legado)";
+    }
+    else
+    {
+        text = QString("Driver: Conectado (%1, transporte: %2)")
+                   .arg(status->capabilities)
+                   .arg(status->sharedTransportActive ? "memória compartilhada" : "socket");
+        text += QString("\nFila de envio: %1 mensagens (%2 KiB), pico %3 · frames substituídos por mais novos: %4")
+                    .arg(status->sendQueueDepth)
+                    .arg(status->sendQueueBytes / 1024)
+                    .arg(status->sendQueuePeak)
+                    .arg(status->framesCoalesced);
+        if (status->hasLinkSamples)
+        {
+            text += "\n" + describeLinkStats(*status);
+        }
+    }
+    driverStatusLabel->setText(text);
 }
-
@@ -21,8 +21,9 @@
 #include <QMenu>
 #include <QTimer>
 #include <QMutex>
-#include <QLocalSocket>
-#include <QScopedPointer>
+#include <QThread>
+
+#include "WDLSyncWorker.h"
 
 // Logger simples conforme Etapa 1.2.2 do roadmap
 class WDLLogger {
@@ -67,6 +68,9 @@ private:
     QLabel* directionEffectLabel;
     QLabel* primaryColorLabel;
     QLabel* secondaryColorLabel;
+    QLabel* driverStatusLabel = nullptr;
+    QLabel* syncStatsLabel = nullptr;
+    QLabel* syncRateLabel = nullptr;
 
     // Dispositivos
     QLabel* deviceCountLabel;
@@ -74,10 +78,17 @@ private:
 
     // Configurações
     QSpinBox* syncIntervalSpinbox;
+    QCheckBox* adaptiveIntervalCheckbox;
     QCheckBox* enableBrightnessCheckbox;
     QWidget* brightnessContainer;
     QSlider* brightnessSlider;
     QLabel* brightnessValueLabel;
+    QComboBox* effectCombo;
+    QComboBox* directionCombo;
+    QSlider* effectSpeedSlider;
+    QPushButton* secondaryColorButton;
+    QSpinBox* transitionSpinbox;
+    QSpinBox* transitionFpsSpinbox;
 
     // Informações do Sistema
     QLabel* osInfoLabel;
@@ -97,43 +108,74 @@ private:
     bool   isDynamicLightingAvailable = false; // espelha isLampArrayApiAvailable
     bool   isPluginEnabled = false;            // espelha syncEnabled
     int    syncIntervalMs = 100;               // já existente
+    bool   adaptiveInterval = true;            // intervalo pelo custo medido
     double brightnessMultiplier = 1.0;         // espelha brightnessOverride
+    bool   sharedTransportEnabled = true;      // preferência persistida (Hello)
+    QString colorSourceSpec;                   // ColorSource::create(); WDL_COLOR_SOURCE sobrepõe
 
     // Temporização e ajustes de brilho
-    QTimer* syncTimer = nullptr;
     bool    brightnessOverrideEnabled = false;
     double  brightnessOverride = 1.0; // 0.0 - 1.0
 
+    // Transição suave entre cores/efeitos
+    int transitionMs = 300; // 0 = troca imediata
+    int transitionFps = 60;
+
+    // Efeito (a cor primária vem da fonte de cor)
+    EffectParams effectSettings;
+    QVector<LedSpatialIndex::DevicePlacement> devicePlacements; // QSettings "devicePlacement"
+    QVector<CalibrationProfile> calibrationProfiles;            // QSettings "calibration"
+
     // Métodos auxiliares
     void initializeSystemInfo();
     void detectDynamicLightingAPI();
     void refreshUiStatus();
     void refreshDeviceList(); // Atualiza contagem e lista de dispositivos
+    void loadDeviceProfiles(); // Posições no canvas e calibração (QSettings)
     static void DeviceListChangedCallback(void* arg); // Callback estático para mudanças de lista
 
     // Etapa 1.2.1 — novos métodos (invólucros internos)
     bool InitializeDynamicLighting();
     void CheckDynamicLightingAvailability();
     void UpdateDeviceList();
-    bool ConnectToVirtualDriver();
-    void DisconnectFromVirtualDriver();
-
-    // IPC Client (Named Pipe via QLocalSocket)
-    QScopedPointer<QLocalSocket> m_driverSocket;
-    QByteArray m_rxBuffer;
-    QString m_driverServerName = QStringLiteral("OpenRGB_WDL_Driver");
 
-    bool sendMessage(quint16 type, const QByteArray& payload);
+    // Pipeline de sincronização e IPC com o driver em thread própria; a UI
+    // só lê o snapshot de status a cada StatusRefreshIntervalMs
+    static constexpr int StatusRefreshIntervalMs = WDLSyncWorker::StatusPublishIntervalMs;
+    WDLSyncWorker* m_syncWorker = nullptr;
+    QThread*       m_syncThread = nullptr;
+    QTimer*        m_statusTimer = nullptr;
+
+    void startSyncWorker();
+    void stopSyncWorker();
+    bool isPlatformReady() const;
+    void applyEffectSettings(); // envia ao worker e persiste
+
+    // Executa fn(worker) na thread do worker, sem bloquear a UI
+    template <typename Fn>
+    void postToSyncWorker(Fn fn)
+    {
+        if (!m_syncWorker)
+        {
+            return;
+        }
+        WDLSyncWorker* worker = m_syncWorker;
+        QMetaObject::invokeMethod(worker, [worker, fn]() { fn(worker); }, Qt::QueuedConnection);
+    }
 
 private slots:
     void onEnableSyncCheckboxToggled(bool checked);
     void onSyncIntervalSpinboxValueChanged(int value);
+    void onAdaptiveIntervalCheckboxToggled(bool checked);
     void onEnableBrightnessCheckboxToggled(bool checked);
     void onBrightnessSliderValueChanged(int value);
+    void onEffectSettingsChanged();
+    void onSecondaryColorButtonClicked();
+    void onTransitionSettingsChanged();
     void onUpdateButtonClicked();
     void onReloadButtonClicked();
 
-    void onSyncTick();
+    void onStatusRefresh();
 };
 
 #endif // WINDOWSDYNAMICLIGHTINGSYNC_H
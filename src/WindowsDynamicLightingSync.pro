@@ -75,9 +75,33 @@ DEFINES +=
 #-----------------------------------------------------------------------------------------------#
 HEADERS +=                                                                                      \
     WindowsDynamicLightingSync.h                                                                \
+    DriverLinkStats.h                                                                           \
+    DriverSendQueue.h                                                                           \
+    SnapshotBuffer.h                                                                            \
+    WDLSyncWorker.h                                                                             \
+    WorkStealingPool.h                                                                          \
+    ColorSource.h                                                                               \
+    RegistryColorSource.h                                                                       \
+    StreamColorSource.h                                                                         \
+    EffectKernels.h                                                                             \
+    EffectEngine.h                                                                              \
+    LedSpatialIndex.h                                                                           \
+    ColorCalibration.h                                                                          \
+    AdaptiveScheduler.h                                                                         \
+    ../driver/common/SharedFrameRing.h                                                          \
 
 SOURCES +=                                                                                      \
     WindowsDynamicLightingSync.cpp                                                              \
+    WDLSyncWorker.cpp                                                                           \
+    WorkStealingPool.cpp                                                                        \
+    ColorSource.cpp                                                                             \
+    RegistryColorSource.cpp                                                                     \
+    StreamColorSource.cpp                                                                       \
+    EffectEngine.cpp                                                                            \
+    LedSpatialIndex.cpp                                                                         \
+    ColorCalibration.cpp                                                                        \
+    AdaptiveScheduler.cpp                                                                       \
+    ../driver/common/SharedFrameRing.cpp                                                        \
 
 RESOURCES +=                                                                                    \
     resources.qrc
@@ -121,6 +145,7 @@ win32:contains(QMAKE_TARGET.arch, x86_64) {
     LIBS +=                                                                                     \
         -lws2_32                                                                                \
         -lole32                                                                                 \
+        -ladvapi32                                                                              \
         -L"$$(WindowsSdkDir)Lib/$$(WindowsSDKVersion)/um/x64" \
         -lwindowsapp
 }
@@ -129,6 +154,7 @@ win32:contains(QMAKE_TARGET.arch, x86) {
     LIBS +=                                                                                     \
         -lws2_32                                                                                \
         -lole32                                                                                 \
+        -ladvapi32                                                                              \
         -L"$$(WindowsSdkDir)Lib/$$(WindowsSDKVersion)/um/x86" \
         -lwindowsapp
 }
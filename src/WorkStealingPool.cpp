@@ -0,0 +1,104 @@
+#include "WorkStealingPool.h"
+
+#include <QMutexLocker>
+#include <QString>
+
+#include <utility>
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+{
+    threadCount = qMax(1, threadCount);
+    for (int i = 0; i < threadCount; ++i)
+    {
+        m_queues.append(new Queue);
+    }
+    for (int i = 0; i < threadCount; ++i)
+    {
+        QThread* thread = QThread::create([this, i]() { run(i); });
+        thread->setObjectName(QString("WDL Devices %1").arg(i));
+        m_threads.append(thread);
+        thread->start();
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    m_stopping.store(true, std::memory_order_release);
+    m_available.release(m_threads.size());
+    for (QThread* thread : m_threads)
+    {
+        thread->wait();
+    }
+
+    // Permissões de encerramento podem ter saído antes de jobs ainda na fila
+    Job job;
+    while (take(0, job))
+    {
+        job();
+    }
+    qDeleteAll(m_threads);
+    qDeleteAll(m_queues);
+}
+
+void WorkStealingPool::submit(Job job)
+{
+    const int index = static_cast<int>(m_next.fetch_add(1, std::memory_order_relaxed) % static_cast<quint32>(m_queues.size()));
+    {
+        QMutexLocker locker(&m_queues[index]->mutex);
+        m_queues[index]->jobs.push_back(std::move(job));
+    }
+    m_available.release();
+}
+
+bool WorkStealingPool::take(int index, Job& job)
+{
+    // Própria fila pela frente
+    {
+        Queue* own = m_queues[index];
+        QMutexLocker locker(&own->mutex);
+        if (!own->jobs.empty())
+        {
+            job = std::move(own->jobs.front());
+            own->jobs.pop_front();
+            return true;
+        }
+    }
+
+    // Roubo pelo fim, começando pela vizinha
+    for (int k = 1; k < m_queues.size(); ++k)
+    {
+        Queue* victim = m_queues[(index + k) % m_queues.size()];
+        QMutexLocker locker(&victim->mutex);
+        if (!victim->jobs.empty())
+        {
+            job = std::move(victim->jobs.back());
+            victim->jobs.pop_back();
+            m_steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::run(int index)
+{
+    for (;;)
+    {
+        m_available.acquire();
+
+        // Cada permissão corresponde a um job ainda não tomado ou ao
+        // encerramento. A varredura das filas não é atômica: outra thread
+        // pode levar o job visto aqui e deixar o seu numa fila já
+        // varrida, então sem encerramento a busca recomeça.
+        Job job;
+        while (!take(index, job))
+        {
+            if (m_stopping.load(std::memory_order_acquire))
+            {
+                return;
+            }
+            QThread::yieldCurrentThread();
+        }
+        job();
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <QMutex>
+#include <QSemaphore>
+#include <QThread>
+#include <QVector>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+
+// Pool fixo de threads com uma fila por thread. submit() distribui os jobs
+// em round-robin; cada thread consome a própria fila pela frente e, quando
+// ela esvazia, rouba do fim da fila das outras. Assim um job lento prende
+// só a sua thread: o que estava atrás dele é levado pelas demais.
+//
+// submit() pode ser chamado de qualquer thread. O destrutor executa os
+// jobs pendentes e junta as threads.
+class WorkStealingPool
+{
+public:
+    using Job = std::function<void()>;
+
+    explicit WorkStealingPool(int threadCount);
+    ~WorkStealingPool();
+
+    int size() const { return m_threads.size(); }
+
+    void submit(Job job);
+
+    quint64 steals() const { return m_steals.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue
+    {
+        QMutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    QVector<Queue*>   m_queues;
+    QVector<QThread*> m_threads;
+    QSemaphore        m_available; // uma permissão por job (e uma por thread no encerramento)
+    std::atomic<bool> m_stopping { false };
+    std::atomic<quint32> m_next { 0 };
+    std::atomic<quint64> m_steals { 0 };
+
+    void run(int index);
+    bool take(int index, Job& job);
+};
+
+#endif // WORK_STEALING_POOL_H